@@ -26,7 +26,7 @@ std::string Admin::tableName() const {
 }
 
 std::vector<std::string> Admin ::columns() const {
-    return {"userName", "password"};
+    return Schema::names(schema());
 }
 
 std::set<std::string> Admin::keys() const {
@@ -37,18 +37,10 @@ bool Admin::isAutoGeneratedKey() const {
     return false;
 }
 
-std::map<std::string, std::any> Admin ::toMap() const {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = userName;
-    mMap[columns()[1]] = password;
-
-    return mMap;
+int Admin::bindColumn(sqlite3_stmt *statement, int index, int column) const {
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * Admin::fromMap(std::map<std::string, std::any> mMap) const{
-    std::string mUserName = std::any_cast<std::string>(mMap[columns()[0]]);
-    std::string mPassword = std::any_cast<std::string>(mMap[columns()[1]]);
-
-    Admin *model = new Admin (mUserName, mPassword);
-    return model;
+void Admin::readColumn(sqlite3_stmt *statement, int index, int column) {
+    Schema::read(*this, schema(), column, statement, index);
 }
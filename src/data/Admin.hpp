@@ -5,10 +5,11 @@
 #ifndef Admin_hpp
 #define Admin_hpp
 
-#include <map>
+#include <tuple>
 #include <string>
 
 #include "Model.hpp"
+#include "Schema.hpp"
 
 /**
  * @brief represents a row of the admin table in the database
@@ -51,13 +52,20 @@ private:
      */
     std::string password;
 
-    /** override virtual method of the model to set up the new table name, columns, keys, toMap, etc*/
+    /** override virtual method of the model to set up the new table name, columns, keys, schema, etc*/
     virtual std::string tableName() const override;
     virtual std::vector<std::string> columns() const override;
     virtual std::set<std::string> keys() const override;
     virtual bool isAutoGeneratedKey() const override;
-    virtual std::map<std::string, std::any> toMap() const override;
-    virtual Model * fromMap(std::map<std::string, std::any> mMap) const override;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const override;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) override;
+    
+    /** The columns of the table, in order, and the member variables that hold their values. */
+    static constexpr auto schema()
+    {
+        return std::make_tuple(Schema::column("userName", &Admin::userName),
+                               Schema::column("password", &Admin::password));
+    }
 
 };
 
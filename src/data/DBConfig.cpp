@@ -0,0 +1,126 @@
+//
+//  DBConfig.cpp
+//
+
+#include "DBConfig.hpp"
+
+DBConfig DBConfig::fromArgs(int &argc, char **argv)
+{
+    DBConfig config;
+    
+    int remaining = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--db-", 0) != 0)
+        {
+            argv[remaining++] = argv[i];
+            continue;
+        }
+        
+        // Splits "--db-option=value", or takes the value from the next argument.
+        std::string option = arg;
+        std::string value;
+        size_t equals = arg.find('=');
+        if (equals != std::string::npos)
+        {
+            option = arg.substr(0, equals);
+            value = arg.substr(equals + 1);
+        }
+        else if (i + 1 < argc)
+        {
+            value = argv[++i];
+        }
+        else
+        {
+            throw std::runtime_error("Error in DBConfig::fromArgs(). '" + option + "' requires a value.");
+        }
+        
+        try
+        {
+            if (option == "--db-path")
+            {
+                config.path = value;
+            }
+            else if (option == "--db-journal-mode")
+            {
+                config.journalMode = value;
+            }
+            else if (option == "--db-synchronous")
+            {
+                config.synchronous = value;
+            }
+            else if (option == "--db-mmap-size")
+            {
+                config.mmapSize = std::stoll(value);
+            }
+            else if (option == "--db-cache-size")
+            {
+                config.cacheSize = std::stoi(value);
+            }
+            else if (option == "--db-temp-store")
+            {
+                config.tempStore = value;
+            }
+            else if (option == "--db-busy-timeout")
+            {
+                config.busyTimeout = std::stoi(value);
+            }
+            else if (option == "--db-pool-size")
+            {
+                config.poolSize = std::stoi(value);
+            }
+            else if (option == "--db-statement-cache")
+            {
+                config.statementCacheCapacity = std::stoi(value);
+            }
+            else
+            {
+                throw std::runtime_error("Error in DBConfig::fromArgs(). '" + option + "' is not a valid option.");
+            }
+        }
+        catch (const std::logic_error &)
+        {
+            // std::stoi and std::stoll throw std::invalid_argument or std::out_of_range.
+            throw std::runtime_error("Error in DBConfig::fromArgs(). '" + value + "' is not a valid value for '" + option + "'.");
+        }
+    }
+    argc = remaining;
+    argv[argc] = NULL;
+    
+    config.validate();
+    
+    return config;
+}
+
+void DBConfig::validate() const
+{
+    DBConfig copy = *this;
+    validateChoice("journal mode", copy.journalMode, { "DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF" });
+    validateChoice("synchronous", copy.synchronous, { "OFF", "NORMAL", "FULL", "EXTRA" });
+    validateChoice("temp store", copy.tempStore, { "DEFAULT", "FILE", "MEMORY" });
+    
+    if (path.empty())
+    {
+        throw std::runtime_error("Error in DBConfig. The database path cannot be empty.");
+    }
+    if (mmapSize < 0 || busyTimeout < 0 || poolSize < 0 || statementCacheCapacity < 0)
+    {
+        throw std::runtime_error("Error in DBConfig. mmap size, busy timeout, pool size and statement cache capacity cannot be negative.");
+    }
+}
+
+void DBConfig::validateChoice(const std::string &option, std::string &value, const std::set<std::string> &validValues)
+{
+    std::string valueUpper;
+    for (std::string::iterator it = value.begin(); it != value.end(); it++)
+    {
+        valueUpper.push_back(std::toupper(*it));
+    }
+    value = valueUpper;
+    
+    if (!validValues.count(value))
+    {
+        throw std::runtime_error("Error in DBConfig. '" + value + "' is not a valid " + option + ".");
+    }
+}
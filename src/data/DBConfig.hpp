@@ -0,0 +1,85 @@
+//
+//  DBConfig.hpp
+//
+
+#ifndef DBConfig_hpp
+#define DBConfig_hpp
+
+#include <string>
+#include <set>
+#include <stdexcept>
+#include <cctype>
+
+/**
+ * @brief Settings used by DBHelper to open the database.
+ *
+ * Covers the database file and the pragmas applied to every connection when it is opened.
+ * The defaults put the database in WAL mode so that readers and writers do not block each other.
+ *
+ * Any setting can be overridden from the command line with DBConfig::fromArgs(), e.g.
+ *     ./Main --db-path=/tmp/scratch.db --db-synchronous=FULL --docroot . --http-listen localhost:8080
+ */
+struct DBConfig
+{
+    /** The database file. */
+    std::string path = "sql/data.db";
+
+    /** PRAGMA journal_mode: DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF. */
+    std::string journalMode = "WAL";
+
+    /** PRAGMA synchronous: OFF, NORMAL, FULL or EXTRA. NORMAL is durable in WAL mode except on power loss. */
+    std::string synchronous = "NORMAL";
+
+    /** PRAGMA mmap_size, in bytes. 0 disables memory-mapped I/O. */
+    long long mmapSize = 256LL * 1024 * 1024;
+
+    /** PRAGMA cache_size. Positive values are pages, negative values are KiB. */
+    int cacheSize = -16000;
+
+    /** PRAGMA temp_store: DEFAULT, FILE or MEMORY. */
+    std::string tempStore = "MEMORY";
+
+    /** How long a connection waits for another connection's lock before failing with SQLITE_BUSY, in milliseconds. */
+    int busyTimeout = 5000;
+
+    /** The maximum number of pooled connections. 0 uses one per core, with a minimum of 4. */
+    int poolSize = 0;
+
+    /** The maximum number of prepared statements cached by each connection. */
+    int statementCacheCapacity = 64;
+
+    /**
+     * @brief Reads the "--db-*" options from the command line and removes them from argv.
+     *
+     * Options can be given as "--db-path=FILE" or "--db-path FILE". The remaining arguments are moved to the front of argv
+     * and argc is updated, so that the rest of the command line can be passed on to Wt unchanged.
+     * Throws a runtime exception if an option is unknown or its value is invalid.
+     *
+     * Options: --db-path, --db-journal-mode, --db-synchronous, --db-mmap-size, --db-cache-size, --db-temp-store,
+     *          --db-busy-timeout, --db-pool-size, --db-statement-cache
+     *
+     * @param argc number of command line args, updated to the number that remain
+     * @param argv command line args
+     * @return the default settings, overridden by the options given
+     */
+    static DBConfig fromArgs(int &argc, char **argv);
+
+    /**
+     * @brief Throws a runtime exception if a setting is invalid.
+     *
+     * The pragma settings are put into the SQL text, so they are checked against the values SQLite3 accepts.
+     */
+    void validate() const;
+
+private:
+    /**
+     * @brief Changes value to uppercase, then throws a runtime exception if it is not one of the valid values.
+     *
+     * @param option the option name, used for the error message
+     * @param value the value to check
+     * @param validValues the accepted values
+     */
+    static void validateChoice(const std::string &option, std::string &value, const std::set<std::string> &validValues);
+};
+
+#endif /* DBConfig_hpp */
@@ -0,0 +1,64 @@
+//
+//  DBConnection.cpp
+//
+
+#include "DBConnection.hpp"
+
+DBConnection::DBConnection(const DBConfig &config) : statementCache(config.statementCacheCapacity)
+{
+    // Each connection is only used by one thread at a time, so SQLite3 does not need to serialize access to it.
+    int result = sqlite3_open_v2(config.path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX, NULL);
+    if (result != SQLITE_OK)
+    {
+        std::string sqliteMessage = db != NULL ? sqlite3_errmsg(db) : sqlite3_errstr(result);
+        sqlite3_close(db);
+        throw std::runtime_error("Error opening database. SQLite3 error " + std::to_string(result) + ": " + sqliteMessage);
+    }
+    
+    // Other connections may be writing, wait for their locks instead of failing with SQLITE_BUSY.
+    sqlite3_busy_timeout(db, config.busyTimeout);
+    
+    try
+    {
+        // In WAL mode readers do not block the writer and the writer does not block readers.
+        execPragma("journal_mode=" + config.journalMode);
+        execPragma("synchronous=" + config.synchronous);
+        execPragma("mmap_size=" + std::to_string(config.mmapSize));
+        execPragma("cache_size=" + std::to_string(config.cacheSize));
+        execPragma("temp_store=" + config.tempStore);
+    }
+    catch (...)
+    {
+        sqlite3_close(db);
+        throw;
+    }
+}
+
+DBConnection::~DBConnection()
+{
+    // Cached statements must be finalized before the handle can be closed.
+    statementCache.clear();
+    sqlite3_close(db);
+}
+
+sqlite3 * DBConnection::getHandle()
+{
+    return db;
+}
+
+StatementCache & DBConnection::getStatementCache()
+{
+    return statementCache;
+}
+
+void DBConnection::execPragma(const std::string &pragma)
+{
+    char *errorMessage = NULL;
+    int result = sqlite3_exec(db, ("PRAGMA " + pragma + ";").c_str(), NULL, NULL, &errorMessage);
+    if (result != SQLITE_OK)
+    {
+        std::string sqliteMessage = errorMessage != NULL ? errorMessage : sqlite3_errstr(result);
+        sqlite3_free(errorMessage);
+        throw std::runtime_error("Error setting 'PRAGMA " + pragma + "'. SQLite3 error " + std::to_string(result) + ": " + sqliteMessage);
+    }
+}
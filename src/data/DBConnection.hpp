@@ -0,0 +1,91 @@
+//
+//  DBConnection.hpp
+//
+
+#ifndef DBConnection_hpp
+#define DBConnection_hpp
+
+#include <string>
+#include <stdexcept>
+
+#include "sqlite3.h"
+
+#include "DBConfig.hpp"
+#include "StatementCache.hpp"
+
+/**
+ * @brief A SQLite3 database handle together with the statements prepared on it.
+ *
+ * Prepared statements belong to the handle they were prepared on, so each connection has its own StatementCache.
+ * A connection must only be used by one thread at a time. DBConnectionPool hands connections out to threads.
+ */
+class DBConnection
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * Opens the SQLite3 database handle using config.path and applies the pragmas from config.
+     * Throws a runtime exception if it cannot be opened.
+     *
+     * @param config the database file, pragmas, and statement cache capacity
+     */
+    DBConnection(const DBConfig &config);
+
+    /**
+     * @brief Destructor.
+     *
+     * Finalizes the cached statements and closes the handle.
+     */
+    ~DBConnection();
+
+    /**
+     * @brief Gets the SQLite3 database handle.
+     *
+     * @return the database handle
+     */
+    sqlite3 * getHandle();
+
+    /**
+     * @brief Gets the cache of statements prepared on this connection.
+     *
+     * @return the statement cache
+     */
+    StatementCache & getStatementCache();
+
+private:
+    /**
+     * @brief SQLite3 database handle.
+     */
+    sqlite3 *db;
+
+    /**
+     * @brief Prepared statements that can be reused, keyed by their query text.
+     */
+    StatementCache statementCache;
+    
+    /**
+     * @brief Runs a PRAGMA statement on the handle.
+     *
+     * Throws a runtime exception if it fails.
+     *
+     * @param pragma the pragma and its value, e.g. "journal_mode=WAL"
+     */
+    void execPragma(const std::string &pragma);
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented, the connection owns its handle.
+     */
+    DBConnection(const DBConnection &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented, the connection owns its handle.
+     */
+    DBConnection& operator=(const DBConnection &other);
+};
+
+#endif /* DBConnection_hpp */
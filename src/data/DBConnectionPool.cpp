@@ -0,0 +1,154 @@
+//
+//  DBConnectionPool.cpp
+//
+
+#include "DBConnectionPool.hpp"
+
+thread_local std::map<const DBConnectionPool *, DBConnection *> DBConnectionPool::threadConnections;
+
+DBConnectionPool::Lease::Lease()
+{
+    this->pool = NULL;
+    this->connection = NULL;
+}
+
+DBConnectionPool::Lease::Lease(DBConnectionPool *pool, DBConnection *connection)
+{
+    this->pool = pool;
+    this->connection = connection;
+}
+
+DBConnectionPool::Lease::Lease(Lease &&other)
+{
+    pool = other.pool;
+    connection = other.connection;
+    other.pool = NULL;
+    other.connection = NULL;
+}
+
+DBConnectionPool::Lease& DBConnectionPool::Lease::operator=(Lease &&other)
+{
+    if (this != &other)
+    {
+        reset();
+        pool = other.pool;
+        connection = other.connection;
+        other.pool = NULL;
+        other.connection = NULL;
+    }
+    return *this;
+}
+
+DBConnectionPool::Lease::~Lease()
+{
+    reset();
+}
+
+DBConnection * DBConnectionPool::Lease::get() const
+{
+    return connection;
+}
+
+DBConnection * DBConnectionPool::Lease::operator->() const
+{
+    return connection;
+}
+
+DBConnection & DBConnectionPool::Lease::operator*() const
+{
+    return *connection;
+}
+
+void DBConnectionPool::Lease::reset()
+{
+    if (pool != NULL && connection != NULL)
+    {
+        pool->checkin(connection);
+    }
+    pool = NULL;
+    connection = NULL;
+}
+
+DBConnectionPool::DBConnectionPool(const DBConfig &config, int size)
+{
+    if (!sqlite3_threadsafe())
+    {
+        throw std::runtime_error("Error creating connection pool. SQLite3 was compiled without thread safety.");
+    }
+    
+    this->config = config;
+    this->size = size > 0 ? size : 1;
+}
+
+DBConnectionPool::~DBConnectionPool()
+{
+    for (std::vector<DBConnection *>::iterator it = connections.begin(); it != connections.end(); it++)
+    {
+        delete *it;
+    }
+}
+
+DBConnectionPool::Lease DBConnectionPool::acquire()
+{
+    // The thread already holds a connection of this pool. Borrowing it keeps nested queries on one connection.
+    std::map<const DBConnectionPool *, DBConnection *>::iterator held = threadConnections.find(this);
+    if (held != threadConnections.end())
+    {
+        return Lease(NULL, held->second);
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    while (idle.empty() && (int)connections.size() >= size)
+    {
+        available.wait(lock);
+    }
+    
+    DBConnection *connection;
+    if (!idle.empty())
+    {
+        // The most recently used connection is reused first, since its statement cache is the warmest.
+        connection = idle.back();
+        idle.pop_back();
+    }
+    else
+    {
+        connection = new DBConnection(config);
+        connections.push_back(connection);
+    }
+    
+    threadConnections[this] = connection;
+    return Lease(this, connection);
+}
+
+int DBConnectionPool::getSize() const
+{
+    return size;
+}
+
+StatementCache::Stats DBConnectionPool::getStatementCacheStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    
+    StatementCache::Stats result;
+    for (std::vector<DBConnection *>::const_iterator it = connections.begin(); it != connections.end(); it++)
+    {
+        StatementCache::Stats stats = (*it)->getStatementCache().getStats();
+        result.hits += stats.hits;
+        result.misses += stats.misses;
+        result.size += stats.size;
+        result.capacity += stats.capacity;
+    }
+    
+    return result;
+}
+
+void DBConnectionPool::checkin(DBConnection *connection)
+{
+    threadConnections.erase(this);
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(connection);
+    }
+    available.notify_one();
+}
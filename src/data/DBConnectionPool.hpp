@@ -0,0 +1,213 @@
+//
+//  DBConnectionPool.hpp
+//
+
+#ifndef DBConnectionPool_hpp
+#define DBConnectionPool_hpp
+
+#include <map>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include "DBConfig.hpp"
+#include "DBConnection.hpp"
+#include "StatementCache.hpp"
+
+/**
+ * @brief Thread-safe pool of database connections.
+ *
+ * Wt runs each session's event handlers on a thread from its thread pool. Instead of every thread sharing one handle,
+ * a thread checks a connection out of the pool with acquire() and the Lease checks it back in when it goes out of scope.
+ * Connections are opened lazily, up to the size of the pool. When all of them are in use, acquire() waits for one to be checked in.
+ *
+ * While a thread holds a connection of a pool, further calls to acquire() on that pool from that thread borrow the same connection
+ * rather than taking another one. This keeps nested queries (and, later, transactions) on one connection and prevents a thread from
+ * waiting on itself. A thread may hold a connection of each of several pools at once.
+ */
+class DBConnectionPool
+{
+public:
+    /**
+     * @brief A connection checked out of the pool.
+     *
+     * Move-only. When the lease that checked the connection out is destroyed, the connection is returned to the pool.
+     * Leases that borrowed the thread's connection do not return it.
+     */
+    class Lease
+    {
+        friend class DBConnectionPool;
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * Creates an empty lease that holds no connection.
+         */
+        Lease();
+
+        /**
+         * @brief Move constructor.
+         *
+         * @param other the lease to take the connection from, left empty
+         */
+        Lease(Lease &&other);
+
+        /**
+         * @brief Move assignment operator overload.
+         *
+         * Returns the connection currently held, if any, then takes the connection from other.
+         *
+         * @param other the lease to take the connection from, left empty
+         * @return this lease
+         */
+        Lease& operator=(Lease &&other);
+
+        /**
+         * @brief Destructor.
+         *
+         * Returns the connection to the pool if this lease checked it out.
+         */
+        ~Lease();
+
+        /**
+         * @brief Gets the leased connection.
+         *
+         * @return the connection, or NULL if the lease is empty
+         */
+        DBConnection * get() const;
+
+        /**
+         * @brief Member access operator overload.
+         *
+         * @return the connection
+         */
+        DBConnection * operator->() const;
+
+        /**
+         * @brief Dereference operator overload.
+         *
+         * @return the connection
+         */
+        DBConnection & operator*() const;
+
+    private:
+        /**
+         * @brief The pool the connection is returned to, or NULL if the connection is borrowed.
+         */
+        DBConnectionPool *pool;
+
+        /**
+         * @brief The leased connection.
+         */
+        DBConnection *connection;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param pool the pool to return the connection to, or NULL if the connection is borrowed
+         * @param connection the leased connection
+         */
+        Lease(DBConnectionPool *pool, DBConnection *connection);
+
+        /**
+         * @brief Returns the connection to the pool if this lease checked it out, and empties the lease.
+         */
+        void reset();
+
+        Lease(const Lease &other) = delete;
+        Lease& operator=(const Lease &other) = delete;
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * No connections are opened until they are needed.
+     *
+     * @param config the settings each connection is opened with
+     * @param size the maximum number of open connections
+     */
+    DBConnectionPool(const DBConfig &config, int size);
+
+    /**
+     * @brief Destructor.
+     *
+     * Closes every connection. All leases must have been destroyed first.
+     */
+    ~DBConnectionPool();
+
+    /**
+     * @brief Checks a connection out of the pool for the calling thread.
+     *
+     * If the calling thread already holds a connection of this pool, it is borrowed instead.
+     * Otherwise waits until a connection is available, opening a new one if the pool is not full.
+     *
+     * @return a lease on the connection
+     */
+    Lease acquire();
+
+    /**
+     * @brief Gets the maximum number of open connections.
+     *
+     * @return the pool size
+     */
+    int getSize() const;
+
+    /**
+     * @brief Gets the statement cache stats of all open connections added together.
+     *
+     * Connections that other threads are using are included. Their counters are atomic and their capacity never changes, so
+     * they can be read without the connection, but the totals may miss the queries that are running at the time.
+     *
+     * @return the combined statement cache stats
+     */
+    StatementCache::Stats getStatementCacheStats() const;
+
+private:
+    /**
+     * @brief The settings each connection is opened with.
+     */
+    DBConfig config;
+
+    /**
+     * @brief The maximum number of open connections.
+     */
+    int size;
+
+    /**
+     * @brief Every connection that has been opened.
+     */
+    std::vector<DBConnection *> connections;
+
+    /**
+     * @brief The connections that are not checked out.
+     */
+    std::vector<DBConnection *> idle;
+
+    /**
+     * @brief Guards connections and idle.
+     */
+    mutable std::mutex mutex;
+
+    /**
+     * @brief Notified when a connection is checked in.
+     */
+    std::condition_variable available;
+
+    /**
+     * @brief The connection the current thread has checked out of each pool, by pool.
+     */
+    static thread_local std::map<const DBConnectionPool *, DBConnection *> threadConnections;
+
+    /**
+     * @brief Returns a connection to the pool and wakes a thread waiting for one.
+     *
+     * @param connection the connection to return
+     */
+    void checkin(DBConnection *connection);
+
+    DBConnectionPool(const DBConnectionPool &other) = delete;
+    DBConnectionPool& operator=(const DBConnectionPool &other) = delete;
+};
+
+#endif /* DBConnectionPool_hpp */
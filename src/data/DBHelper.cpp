@@ -6,8 +6,22 @@
 
 #include "DBHelper.hpp"
 
+#include <algorithm>
+#include <thread>
+
+#include "SchemaMigrator.hpp"
+#include "Transaction.hpp"
+
 const DBHelper * DBHelper::instance = NULL;
 
+DBConfig DBHelper::config;
+
+std::once_flag DBHelper::instanceFlag;
+
+thread_local DBConnectionPool::Lease DBHelper::transactionConnection;
+
+thread_local int DBHelper::transactionDepth = 0;
+
 DBHelper::~DBHelper()
 {
     closeDB();
@@ -15,42 +29,128 @@ DBHelper::~DBHelper()
 
 const DBHelper & DBHelper::getInstance()
 {
-    if (instance == NULL)
-        instance = new DBHelper();
+    std::call_once(instanceFlag, [] { instance = new DBHelper(); });
     return *instance;
 }
 
-long long DBHelper::insert(const Model &model) const
+void DBHelper::configure(const DBConfig &config)
+{
+    if (instance != NULL)
+    {
+        throw std::runtime_error("Error in call to DBHelper::configure(). The database has already been opened.");
+    }
+    config.validate();
+    DBHelper::config = config;
+}
+
+long long DBHelper::count(const Model &model, const std::vector<SqlCondition> &conditions) const
+{
+    return std::get<0>(aggregate<long long>(model, { SqlAggregate("COUNT", "*") }, conditions)[0]);
+}
+
+bool DBHelper::exists(const Model &model, const std::vector<SqlCondition> &conditions) const
 {
     // Generates the query.
     std::string query;
-    query  = "INSERT INTO " + model.tableName() + " ";
-    query += "VALUES (";
-    for (int i = 0; i < model.columns().size(); i++)
+    query  = "SELECT EXISTS (SELECT 1 FROM " + model.tableName();
+    if (!conditions.empty())
     {
-        query += "?,";
+        appendWhereClauseFromConditions(query, conditions);
     }
-    query  = query.substr(0, query.size() - 1);
     query += ");";
     
-    sqlite3_stmt *statement = prepareStatement(query, "insert");
+    bool result = false;
+    forEachResultRow(query, conditions, "exists", [&result](sqlite3_stmt *statement) { Schema::readValue(statement, 0, result); });
+    
+    return result;
+}
+
+std::vector<std::string> DBHelper::explainWhere(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
+                                                const SqlPage &page) const
+{
+    std::vector<int> columnsToSelect;
+    for (int i = 0; i < model.columns().size(); i++)
+    {
+        columnsToSelect.push_back(i);
+    }
+    std::string query = generateSelectQuery(model, conditions, orderBy, columnsToSelect, page);
+    
+    // The parameters are left unbound. The plan only depends on the shape of the query.
+    std::vector<std::string> result;
+    forEachResultRow("EXPLAIN QUERY PLAN " + query, { }, "explainWhere", [&result](sqlite3_stmt *statement) {
+        std::string detail;
+        Schema::readValue(statement, 3, detail);
+        result.push_back(detail);
+    });
+    
+    return result;
+}
+
+long long DBHelper::insert(const Model &model) const
+{
+    std::vector<int> columnsToBind = generateInsertColumns(model);
+    std::string query = generateInsertQuery(model, columnsToBind);
+    
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "insert");
     
     // Iterates the columns of model and binds their values to the SQL statement.
     int index = 1; // SQL statement parameter index.
-    bindStatementColumns(statement, model, model.columns(), index, "insert");
+    bindStatementColumns(statement, model, columnsToBind, index, "insert");
     
     sqlite3_step(statement);
     
-    finalizeStatement(statement, "Error inserting to '" + model.tableName() + "'.");
+    releaseStatement(*connection, statement, query, "Error inserting to '" + model.tableName() + "'.");
     
     if (model.isAutoGeneratedKey())
     {
-        return sqlite3_last_insert_rowid(db);
+        return sqlite3_last_insert_rowid(connection->getHandle());
     }
     
     return 0;
 }
 
+std::vector<long long> DBHelper::insertManyHelper(const std::vector<const Model *> &models) const
+{
+    std::vector<long long> result;
+    if (models.empty())
+    {
+        return result;
+    }
+    result.reserve(models.size());
+    
+    const Model &firstModel = *models[0];
+    std::vector<int> columnsToBind = generateInsertColumns(firstModel);
+    std::string query = generateInsertQuery(firstModel, columnsToBind);
+    
+    // One transaction for the whole batch, so it costs a single commit and is rolled back if any insert fails.
+    Transaction transaction;
+    
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "insert");
+    
+    for (std::vector<const Model *>::const_iterator it = models.begin(); it != models.end(); it++)
+    {
+        // Every parameter is bound again for each model, so the bindings do not need to be cleared in between.
+        int index = 1; // SQL statement parameter index.
+        bindStatementColumns(statement, **it, columnsToBind, index, "insert");
+        
+        if (sqlite3_step(statement) != SQLITE_DONE)
+        {
+            releaseStatement(*connection, statement, query, "Error inserting to '" + firstModel.tableName() + "'.");
+        }
+        sqlite3_reset(statement);
+        
+        result.push_back(firstModel.isAutoGeneratedKey() ? sqlite3_last_insert_rowid(connection->getHandle()) : 0);
+    }
+    
+    releaseStatement(*connection, statement, query, "Error inserting to '" + firstModel.tableName() + "'.");
+    
+    transaction.commit();
+    
+    return result;
+}
+
 void DBHelper::update(const Model &model) const
 {
     std::set<std::string> keys = model.keys();
@@ -63,41 +163,44 @@ void DBHelper::update(const Model &model) const
     // Names of all columns of the SQL table.
     std::vector<std::string> allColumns = model.columns();
     
-    // Names of the columns to be updated.
+    // Indexes of the columns to be updated.
     // Used to generate the SET command of the query. The corresponding values in the model will be bound to the SET command.
-    std::vector<std::string> columnsToBind;
+    std::vector<int> columnsToBind;
     
-    // Names of primary key columns.
+    // Indexes of primary key columns.
     // Used to generate the WHERE clause of the query. The corresponding values in the model will be bound to the WHERE clause.
-    std::vector<std::string> keysToBind;
+    std::vector<int> keysToBind;
+    std::vector<std::string> keyNames;
     
-    for (std::vector<std::string>::iterator it = allColumns.begin(); it != allColumns.end(); it++)
+    for (int i = 0; i < allColumns.size(); i++)
     {
         // Keys should not be updated.
-        if (keys.count(*it))
+        if (keys.count(allColumns[i]))
         {
-            keysToBind.push_back(*it);
+            keysToBind.push_back(i);
+            keyNames.push_back(allColumns[i]);
         }
         // All other columns will be updated.
         else
         {
-            columnsToBind.push_back(*it);
+            columnsToBind.push_back(i);
         }
     }
     
     // Generates the query.
     std::string query;
     query  = "UPDATE " + model.tableName() + " SET ";
-    for (std::vector<std::string>::iterator it = columnsToBind.begin(); it != columnsToBind.end(); it++)
+    for (std::vector<int>::iterator it = columnsToBind.begin(); it != columnsToBind.end(); it++)
     {
-        query += *it + " = ?,";
+        query += allColumns[*it] + " = ?,";
     }
     query  = query.substr(0, query.size() - 1);
-    query += generateWhereClauseFromKeys(keysToBind);
+    query += generateWhereClauseFromKeys(keyNames);
     query  = query.substr(0, query.size() - 5);
     query += ";";
     
-    sqlite3_stmt *statement = prepareStatement(query, "update");
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "update");
     
     // Iterates the columns, then keys, binding their corresponding values in model to the statement.
     int index = 1; // SQL statement parameter index.
@@ -106,7 +209,7 @@ void DBHelper::update(const Model &model) const
     
     sqlite3_step(statement);
     
-    finalizeStatement(statement, "Error updating '" + model.tableName() + "'.");
+    releaseStatement(*connection, statement, query, "Error updating '" + model.tableName() + "'.");
 }
 
 void DBHelper::updateWhere(const Model &model, const std::vector<SqlCondition> &conditions, const std::set<std::string> &columns) const
@@ -116,40 +219,41 @@ void DBHelper::updateWhere(const Model &model, const std::vector<SqlCondition> &
     // Names of all columns of the SQL table.
     std::vector<std::string> allColumns = model.columns();
     
-    // Names of the columns to be updated.
+    // Indexes of the columns to be updated.
     // Used to generate the SET command of the query. The corresponding values in the model will be bound to the SET command.
-    std::vector<std::string> columnsToBind;
+    std::vector<int> columnsToBind;
     
-    for (std::vector<std::string>::iterator it = allColumns.begin(); it != allColumns.end(); it++)
+    for (int i = 0; i < allColumns.size(); i++)
     {
         // Keys should not be updated.
-        if (keys.count(*it))
+        if (keys.count(allColumns[i]))
         {
             continue;
         }
         // Only columns given in the columns parameter will be updated.
         // If the columns parameter is empty, then all columns will updated.
-        if (columns.empty() || columns.count(*it))
+        if (columns.empty() || columns.count(allColumns[i]))
         {
-            columnsToBind.push_back(*it);;
+            columnsToBind.push_back(i);
         }
     }
     
     // Generates the query.
     std::string query;
     query  = "UPDATE " + model.tableName() + " SET ";
-    for (std::vector<std::string>::iterator it = columnsToBind.begin(); it != columnsToBind.end(); it++)
+    for (std::vector<int>::iterator it = columnsToBind.begin(); it != columnsToBind.end(); it++)
     {
-        query += *it + " = ?,";
+        query += allColumns[*it] + " = ?,";
     }
     query  = query.substr(0, query.size() - 1);
     if (!conditions.empty())
     {
-        query += generateWhereClauseFromConditions(conditions);
+        appendWhereClauseFromConditions(query, conditions);
     }
     query += ";";
     
-    sqlite3_stmt *statement = prepareStatement(query, "Error preparing update statement.");
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "Error preparing update statement.");
     
     // Iterates the columns of model and binds their values to the SET command of the SQL statement.
     // Then iterates the conditions and binds their values to the WHERE clause of the SQL statement.
@@ -159,7 +263,7 @@ void DBHelper::updateWhere(const Model &model, const std::vector<SqlCondition> &
     
     sqlite3_step(statement);
     
-    finalizeStatement(statement, "Error updating '" + model.tableName() + "'.");
+    releaseStatement(*connection, statement, query, "Error updating '" + model.tableName() + "'.");
 }
 
 void DBHelper::destroy(const Model &model) const
@@ -174,26 +278,29 @@ void DBHelper::destroy(const Model &model) const
     // Names of all columns of the SQL table.
     std::vector<std::string> allColumns = model.columns();
 
-    // Names of primary key columns.
+    // Indexes of primary key columns.
     // Used to generate the WHERE clause of the query. The corresponding values in the model will be bound to the WHERE clause.
-    std::vector<std::string> keysToBind;
+    std::vector<int> keysToBind;
+    std::vector<std::string> keyNames;
     
-    for (std::vector<std::string>::iterator it = allColumns.begin(); it != allColumns.end(); it++)
+    for (int i = 0; i < allColumns.size(); i++)
     {
-        if (keys.count(*it))
+        if (keys.count(allColumns[i]))
         {
-            keysToBind.push_back(*it);
+            keysToBind.push_back(i);
+            keyNames.push_back(allColumns[i]);
         }
     }
     
     // Generates the query.
     std::string query;
     query  = "DELETE FROM " + model.tableName();
-    query += generateWhereClauseFromKeys(keysToBind);
+    query += generateWhereClauseFromKeys(keyNames);
     query  = query.substr(0, query.size() - 5);
     query += ";";
     
-    sqlite3_stmt *statement = prepareStatement(query, "destroy");
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "destroy");
     
     // Iterates the keys of model and binds their values to the WHERE clause of the SQL statement.
     int index = 1; // SQL statement parameter index.
@@ -201,7 +308,7 @@ void DBHelper::destroy(const Model &model) const
     
     sqlite3_step(statement);
     
-    finalizeStatement(statement, "Error deleting from '" + model.tableName() + "'.");
+    releaseStatement(*connection, statement, query, "Error deleting from '" + model.tableName() + "'.");
 }
 
 void DBHelper::destroyWhere(const Model &model, const std::vector<SqlCondition> &conditions) const
@@ -211,11 +318,12 @@ void DBHelper::destroyWhere(const Model &model, const std::vector<SqlCondition>
     query  = "DELETE FROM " + model.tableName();
     if (!conditions.empty())
     {
-        query += generateWhereClauseFromConditions(conditions);
+        appendWhereClauseFromConditions(query, conditions);
     }
     query += ";";
     
-    sqlite3_stmt *statement = prepareStatement(query, "destroyWhere");
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "destroyWhere");
     
     // Iterates the conditions and binds their values to the WHERE clause of the SQL statement.
     int index = 1;
@@ -223,134 +331,323 @@ void DBHelper::destroyWhere(const Model &model, const std::vector<SqlCondition>
     
     sqlite3_step(statement);
     
-    finalizeStatement(statement, "Error deleting from '" + model.tableName() + "'.");
+    releaseStatement(*connection, statement, query, "Error deleting from '" + model.tableName() + "'.");
+}
+
+void DBHelper::beginTransaction() const
+{
+    if (transactionDepth == 0)
+    {
+        DBConnectionPool::Lease connection = pool->acquire();
+        execute(*connection, "BEGIN IMMEDIATE;", "beginTransaction");
+        transactionConnection = std::move(connection);
+    }
+    else
+    {
+        execute(*transactionConnection, "SAVEPOINT DBHelper_" + std::to_string(transactionDepth) + ";", "beginTransaction");
+    }
+    transactionDepth++;
+}
+
+void DBHelper::commit() const
+{
+    if (transactionDepth == 0)
+    {
+        throw std::runtime_error("Error in call to DBHelper::commit(). No transaction is active.");
+    }
+    
+    if (transactionDepth > 1)
+    {
+        execute(*transactionConnection, "RELEASE DBHelper_" + std::to_string(transactionDepth - 1) + ";", "commit");
+        transactionDepth--;
+        return;
+    }
+    
+    try
+    {
+        execute(*transactionConnection, "COMMIT;", "commit");
+    }
+    catch (...)
+    {
+        // The transaction is still open if COMMIT failed. It is rolled back so the connection can be returned to the pool.
+        sqlite3_exec(transactionConnection->getHandle(), "ROLLBACK;", NULL, NULL, NULL);
+        transactionDepth = 0;
+        transactionConnection = DBConnectionPool::Lease();
+        throw;
+    }
+    transactionDepth = 0;
+    transactionConnection = DBConnectionPool::Lease();
+}
+
+void DBHelper::rollback() const
+{
+    if (transactionDepth == 0)
+    {
+        throw std::runtime_error("Error in call to DBHelper::rollback(). No transaction is active.");
+    }
+    
+    // The depth is decreased first, so that if rolling back fails the enclosing transaction can still be ended.
+    if (transactionDepth > 1)
+    {
+        transactionDepth--;
+        std::string savepoint = "DBHelper_" + std::to_string(transactionDepth);
+        execute(*transactionConnection, "ROLLBACK TO " + savepoint + ";", "rollback");
+        execute(*transactionConnection, "RELEASE " + savepoint + ";", "rollback");
+        return;
+    }
+    
+    transactionDepth = 0;
+    DBConnectionPool::Lease connection = std::move(transactionConnection);
+    execute(*connection, "ROLLBACK;", "rollback");
+}
+
+int DBHelper::getTransactionDepth() const
+{
+    return transactionDepth;
+}
+
+StatementCache::Stats DBHelper::getStatementCacheStats() const
+{
+    return pool->getStatementCacheStats();
 }
 
 DBHelper::DBHelper()
 {
-    openDB();
+    openDB(config);
 }
 
-std::vector<Model *> DBHelper::selectWhereHelper(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
-                                                 const std::set<std::string> &columns) const
+long long DBHelper::forEachWhereHelper(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
+                                       const std::set<std::string> &columns, const SqlPage &page, Model &row,
+                                       const std::function<void()> &onRow) const
 {
     // Names of all columns of the SQL table.
     std::vector<std::string> allColumns = model.columns();
     
-    std::vector<std::string> columnsToSelect;
-    for (std::vector<std::string>::iterator it = allColumns.begin(); it != allColumns.end(); it++)
+    // Indexes of the selected columns. The nth result column is read into column columnsToSelect[n] of the model.
+    std::vector<int> columnsToSelect;
+    for (int i = 0; i < allColumns.size(); i++)
     {
         // Only columns given in the columns parameter should be selected, unless the columns parameter is empty.
-        if (columns.empty() || columns.count(*it))
+        if (columns.empty() || columns.count(allColumns[i]))
+        {
+            columnsToSelect.push_back(i);
+        }
+    }
+    
+    std::string query = generateSelectQuery(model, conditions, orderBy, columnsToSelect, page);
+    
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, "Error preparing select statement.");
+    
+    // Iterates the conditions and binds their values to the WHERE clause of the SQL statement, followed by the cursor and limit.
+    int index = 1;
+    bindStatementConditions(statement, conditions, index, "forEachWhere");
+    bindStatementConditions(statement, page.cursor, index, "forEachWhere");
+    if (page.limit > 0 || page.offset > 0)
+    {
+        // A negative limit is no limit.
+        sqlite3_bind_int(statement, index++, page.limit > 0 ? page.limit : -1);
+        sqlite3_bind_int(statement, index++, page.offset);
+    }
+    
+    // Runs the select statement and reads each row of the results into row, one column at a time.
+    long long rowCount = 0;
+    int columnCount = (int)columnsToSelect.size();
+    try
+    {
+        while (sqlite3_step(statement) == SQLITE_ROW)
         {
-            columnsToSelect.push_back(*it);
+            for (int i = 0; i < columnCount; i++)
+            {
+                row.readColumn(statement, i, columnsToSelect[i]);
+            }
+            onRow();
+            rowCount++;
         }
     }
+    catch (...)
+    {
+        // The statement is given back before passing on the exception thrown by onRow.
+        // It was stopped at a row, not an error, so releasing it does not throw.
+        releaseStatement(*connection, statement, query, "Error reading from database.");
+        throw;
+    }
+    
+    releaseStatement(*connection, statement, query, "Error reading from database.");
     
+    return rowCount;
+}
+
+void DBHelper::aggregateHelper(const Model &model, const std::vector<SqlAggregate> &aggregates, const std::vector<SqlCondition> &conditions,
+                               const std::string &groupBy, const std::function<void(sqlite3_stmt *)> &onRow) const
+{
     // Generates the query.
     std::string query;
     query  = "SELECT ";
-    for (std::vector<std::string>::iterator it = columnsToSelect.begin(); it != columnsToSelect.end(); it++)
+    for (std::vector<SqlAggregate>::const_iterator it = aggregates.begin(); it != aggregates.end(); it++)
     {
-        query += *it + ",";
+        query += it->toSql() + ",";
     }
-    query = query.substr(0, query.size() - 1);
+    query  = query.substr(0, query.size() - 1);
     query += " FROM " + model.tableName();
     if (!conditions.empty())
     {
-        query += generateWhereClauseFromConditions(conditions);
+        appendWhereClauseFromConditions(query, conditions);
     }
-    if (!orderBy.empty())
+    if (!groupBy.empty())
     {
-        query += " ORDER BY " + orderBy;
+        query += " GROUP BY " + groupBy + " ORDER BY " + groupBy;
     }
     query += ";";
     
-    sqlite3_stmt *statement = prepareStatement(query, "Error preparing select statement.");
+    forEachResultRow(query, conditions, "aggregate", onRow);
+}
+
+void DBHelper::forEachResultRow(const std::string &query, const std::vector<SqlCondition> &conditions, const std::string &queryType,
+                                const std::function<void(sqlite3_stmt *)> &onRow) const
+{
+    DBConnectionPool::Lease connection = pool->acquire();
+    sqlite3_stmt *statement = prepareStatement(*connection, query, queryType);
     
     // Iterates the conditions and binds their values to the WHERE clause of the SQL statement.
     int index = 1;
-    bindStatementConditions(statement, conditions, index, "selectWhereHelper");
-    
-    // The result vector to be returned.
-    std::vector<Model *> result;
+    bindStatementConditions(statement, conditions, index, queryType);
     
-    // Runs the select statement and creates a Model subclass object for each row of the results.
-    int stepResult = sqlite3_step(statement);
-    int columnCount = sqlite3_column_count(statement);
-    while (stepResult == SQLITE_ROW)
+    try
     {
-        // The map is used to determine column types and use the appropriate function to assign results back to the map.
-        std::map<std::string, std::any> row = model.toMap();
-        for (int i = 0; i < columnCount; i++)
+        while (sqlite3_step(statement) == SQLITE_ROW)
         {
-            const char *columnName = sqlite3_column_name(statement, i);
-            const std::type_info *attrType = &row[columnName].type();
-            if (*attrType == typeid(bool)) {
-                row[columnName] = sqlite3_column_int(statement, i);
-            }
-            if (*attrType == typeid(int)) {
-                row[columnName] = sqlite3_column_int(statement, i);
-            }
-            if (*attrType == typeid(double))
-            {
-                row[columnName] = sqlite3_column_double(statement, i);
-            }
-            if (*attrType == typeid(std::string))
-            {
-                row[columnName] = std::string((const char*)sqlite3_column_text(statement, i));
-            }
+            onRow(statement);
         }
-        // Creates a new object from the map.
-        // Uses dynamic memory. Results are dereferenced then deleted in DBHelper::selectWhere().
-        result.push_back(model.fromMap(row));
-        
-        stepResult = sqlite3_step(statement);
+    }
+    catch (...)
+    {
+        releaseStatement(*connection, statement, query, "Error reading from database.");
+        throw;
     }
     
-    finalizeStatement(statement, "Error reading from database.");
+    releaseStatement(*connection, statement, query, "Error reading from database.");
+}
+
+std::string DBHelper::generateSelectQuery(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
+                                          const std::vector<int> &columnsToSelect, const SqlPage &page) const
+{
+    // Names of all columns of the SQL table.
+    std::vector<std::string> allColumns = model.columns();
     
-    return result;
+    std::string query;
+    query  = "SELECT ";
+    for (std::vector<int>::const_iterator it = columnsToSelect.begin(); it != columnsToSelect.end(); it++)
+    {
+        query += allColumns[*it] + ",";
+    }
+    query = query.substr(0, query.size() - 1);
+    query += " FROM " + model.tableName();
+    if (!conditions.empty())
+    {
+        appendWhereClauseFromConditions(query, conditions);
+    }
+    if (!page.cursor.empty())
+    {
+        query += (conditions.empty() ? " WHERE " : " AND ") + page.generateCursorComparison();
+    }
+    if (!orderBy.empty())
+    {
+        query += " ORDER BY " + orderBy;
+    }
+    // The limit and offset are bound, so every page shares the same cached statement.
+    if (page.limit > 0 || page.offset > 0)
+    {
+        query += " LIMIT ? OFFSET ?";
+    }
+    query += ";";
+    
+    return query;
 }
 
-sqlite3_stmt * DBHelper::prepareStatement(const std::string &query, const std::string &queryType) const
+sqlite3_stmt * DBHelper::prepareStatement(DBConnection &connection, const std::string &query, const std::string &queryType) const
 {
-    sqlite3_stmt *statement;
-    int prepareResult = sqlite3_prepare_v2(db, query.c_str(), -1, &statement, NULL);
+    sqlite3_stmt *statement = connection.getStatementCache().acquire(query);
+    if (statement != NULL)
+    {
+        return statement;
+    }
+    
+    int prepareResult = sqlite3_prepare_v2(connection.getHandle(), query.c_str(), -1, &statement, NULL);
     if (prepareResult != SQLITE_OK)
     {
         sqlite3_finalize(statement);
         throw std::runtime_error("Error preparing " + queryType + " statement. SQLite3 error " + std::to_string(prepareResult) + ": "
-                                 + std::string(sqlite3_errmsg(db)));
+                                 + std::string(sqlite3_errmsg(connection.getHandle())));
     }
     
     return statement;
 }
 
-std::string DBHelper::generateWhereClauseFromConditions(const std::vector<SqlCondition> &conditions) const
+std::string DBHelper::generateInsertQuery(const Model &model, const std::vector<int> &columns) const
 {
-    std::string result = " WHERE ";
-    for (std::vector<SqlCondition>::const_iterator it = conditions.begin(); it != conditions.end(); it++)
+    // Names of all columns of the SQL table.
+    std::vector<std::string> allColumns = model.columns();
+    
+    std::string query;
+    query  = "INSERT INTO " + model.tableName() + " (";
+    for (std::vector<int>::const_iterator it = columns.begin(); it != columns.end(); it++)
     {
-        if (it->op == "IN")
-        {
-            result += it->field + " " + it->op + " (";
-            for (int i = 0; i < std::any_cast<std::vector<std::string>>(it->value).size(); i++)
-            {
-                result += "?,";
-            }
-            result = result.substr(0, result.size() - 1) + ") AND ";
-        }
-        else
+        query += allColumns[*it] + ",";
+    }
+    query  = query.substr(0, query.size() - 1);
+    query += ") VALUES (";
+    for (int i = 0; i < columns.size(); i++)
+    {
+        query += "?,";
+    }
+    query  = query.substr(0, query.size() - 1);
+    query += ");";
+    
+    return query;
+}
+
+std::vector<int> DBHelper::generateInsertColumns(const Model &model) const
+{
+    std::vector<std::string> allColumns = model.columns();
+    std::set<std::string> keys = model.keys();
+    
+    std::vector<int> result;
+    for (int i = 0; i < allColumns.size(); i++)
+    {
+        // The auto generated key is left out so that SQLite3 will automatically choose a unique value.
+        if (model.isAutoGeneratedKey() && keys.count(allColumns[i]))
         {
-            result += it->field + " " + it->op + " ? AND ";
+            continue;
         }
+        result.push_back(i);
     }
-    result  = result.substr(0, result.size() - 5);
     
     return result;
 }
 
+void DBHelper::execute(DBConnection &connection, const std::string &query, const std::string &queryType) const
+{
+    sqlite3_stmt *statement = prepareStatement(connection, query, queryType);
+    
+    sqlite3_step(statement);
+    
+    releaseStatement(connection, statement, query, "Error running " + queryType + " statement '" + query + "'.");
+}
+
+void DBHelper::appendWhereClauseFromConditions(std::string &query, const std::vector<SqlCondition> &conditions) const
+{
+    query += " WHERE ";
+    for (std::vector<SqlCondition>::const_iterator it = conditions.begin(); it != conditions.end(); it++)
+    {
+        if (it != conditions.begin())
+        {
+            query += " AND ";
+        }
+        it->appendSql(query);
+    }
+}
+
 std::string DBHelper::generateWhereClauseFromKeys(const std::vector<std::string> &keys) const
 {
     std::string result = " WHERE ";
@@ -362,51 +659,19 @@ std::string DBHelper::generateWhereClauseFromKeys(const std::vector<std::string>
     return result;
 }
 
-void DBHelper::bindStatementColumns(sqlite3_stmt *statement, const Model &model, const std::vector<std::string> &columns, int &index,
+void DBHelper::bindStatementColumns(sqlite3_stmt *statement, const Model &model, const std::vector<int> &columns, int &index,
                                     const std::string &queryType) const
 {
-    std::map<std::string, std::any> mMap = model.toMap();
-    
-    for (std::vector<std::string>::const_iterator it = columns.begin(); it != columns.end(); it++)
+    for (std::vector<int>::const_iterator it = columns.begin(); it != columns.end(); it++)
     {
-        int bindResult = -1;
-        
-        if (queryType == "insert" && model.isAutoGeneratedKey() && model.keys().count(*it))
-        {
-            // NULL is binded to the auto generated key column so that SQLite3 will automatically choose a unique value.
-            bindResult = sqlite3_bind_null(statement, index);
-        }
-        else
-        {
-            const std::type_info *attrType = &mMap[*it].type();
-            if (*attrType == typeid(bool))
-            {
-                bindResult = sqlite3_bind_int(statement, index, std::any_cast<bool>(mMap[*it]));
-            }
-            if (*attrType == typeid(int))
-            {
-                bindResult = sqlite3_bind_int(statement, index, std::any_cast<int>(mMap[*it]));
-            }
-            if (*attrType == typeid(double))
-            {
-                bindResult = sqlite3_bind_double(statement, index, std::any_cast<double>(mMap[*it]));
-            }
-            if (*attrType == typeid(std::string))
-            {
-                bindResult = sqlite3_bind_text(statement, index, std::any_cast<std::string>(mMap[*it]).c_str(), -1, SQLITE_TRANSIENT);
-            }
-        }
+        int bindResult = model.bindColumn(statement, index, *it);
         
         if (bindResult != SQLITE_OK)
         {
+            std::string sqliteMessage = sqlite3_errmsg(sqlite3_db_handle(statement));
             sqlite3_finalize(statement);
-            if (bindResult == -1)
-            {
-                throw std::runtime_error("Error in call to DBHelper::" + queryType + "(). The value of '"
-                                         + *it + "' is not a supported data type.");
-            }
             throw std::runtime_error("Error binding " + queryType + " statement. SQLite3 error " + std::to_string(bindResult) + ": "
-                                     + std::string(sqlite3_errmsg(db)));
+                                     + sqliteMessage);
         }
         
         index++;
@@ -416,89 +681,142 @@ void DBHelper::bindStatementColumns(sqlite3_stmt *statement, const Model &model,
 void DBHelper::bindStatementConditions(sqlite3_stmt *statement, const std::vector<SqlCondition> &conditions, int &index,
                                        const std::string &queryType) const
 {
+    typedef SmallVector<int, SqlCondition::INLINE_VALUES> IntValues;
+    typedef SmallVector<double, SqlCondition::INLINE_VALUES> DoubleValues;
+    typedef SmallVector<std::string, SqlCondition::INLINE_VALUES> StringValues;
+    
     for (std::vector<SqlCondition>::const_iterator it = conditions.begin(); it != conditions.end(); it++)
     {
-        int bindResult = -1;
+        // Combined conditions bind the values of the conditions they combine, in the order appendSql() generated them.
+        if (!it->children.empty())
+        {
+            bindStatementConditions(statement, it->children, index, queryType);
+            continue;
+        }
         
-        const std::type_info *attrType = &it->value.type();
-        if (*attrType == typeid(bool))
+        // Strings are bound with SQLITE_STATIC, since the caller's conditions outlive the statement's bindings, which are cleared
+        // by releaseStatement() before the DBHelper method returns.
+        int bindResult = SQLITE_OK;
+        int numValues = 1;
+        const SqlCondition::Value &value = it->value;
+        if (std::holds_alternative<std::monostate>(value))
+        {
+            numValues = 0;
+        }
+        else if (const bool *boolValue = std::get_if<bool>(&value))
         {
-            bindResult = sqlite3_bind_int(statement, index, std::any_cast<bool>(it->value));
+            bindResult = sqlite3_bind_int(statement, index, *boolValue);
         }
-        if (*attrType == typeid(int))
+        else if (const int *intValue = std::get_if<int>(&value))
         {
-            bindResult = sqlite3_bind_int(statement, index, std::any_cast<int>(it->value));
+            bindResult = sqlite3_bind_int(statement, index, *intValue);
         }
-        if (*attrType == typeid(double))
+        else if (const double *doubleValue = std::get_if<double>(&value))
         {
-            bindResult = sqlite3_bind_double(statement, index, std::any_cast<double>(it->value));
+            bindResult = sqlite3_bind_double(statement, index, *doubleValue);
         }
-        if (*attrType == typeid(std::string))
+        else if (const std::string *text = std::get_if<std::string>(&value))
         {
-            bindResult = sqlite3_bind_text(statement, index, std::any_cast<std::string>(it->value).c_str(), -1, SQLITE_TRANSIENT);
+            bindResult = sqlite3_bind_text(statement, index, text->c_str(), (int)text->size(), SQLITE_STATIC);
         }
-        if (*attrType == typeid(std::vector<std::string>))
+        else if (const IntValues *values = std::get_if<IntValues>(&value))
         {
-            std::vector<std::string> in = std::any_cast<std::vector<std::string>>(it->value);
-            for (std::vector<std::string>::iterator itIn = in.begin(); itIn != in.end(); itIn++)
+            numValues = (int)values->size();
+            for (int i = 0; i < numValues && bindResult == SQLITE_OK; i++)
             {
-                bindResult = sqlite3_bind_text(statement, index, std::any_cast<std::string>(*itIn).c_str(), -1, SQLITE_TRANSIENT);
-                if (bindResult != SQLITE_OK)
-                {
-                    sqlite3_finalize(statement);
-                    throw std::runtime_error("Error binding " + queryType + " statement. SQLite3 error " + std::to_string(bindResult) + ": "
-                                             + std::string(sqlite3_errmsg(db)));
-                }
-                index++;
+                bindResult = sqlite3_bind_int(statement, index + i, (*values)[i]);
+            }
+        }
+        else if (const DoubleValues *values = std::get_if<DoubleValues>(&value))
+        {
+            numValues = (int)values->size();
+            for (int i = 0; i < numValues && bindResult == SQLITE_OK; i++)
+            {
+                bindResult = sqlite3_bind_double(statement, index + i, (*values)[i]);
+            }
+        }
+        else if (const StringValues *values = std::get_if<StringValues>(&value))
+        {
+            numValues = (int)values->size();
+            for (int i = 0; i < numValues && bindResult == SQLITE_OK; i++)
+            {
+                const std::string &text = (*values)[i];
+                bindResult = sqlite3_bind_text(statement, index + i, text.c_str(), (int)text.size(), SQLITE_STATIC);
             }
-            index--;
         }
         
         if (bindResult != SQLITE_OK)
         {
+            std::string sqliteMessage = sqlite3_errmsg(sqlite3_db_handle(statement));
             sqlite3_finalize(statement);
-            if (bindResult == -1)
-            {
-                throw std::runtime_error("Error in call to DBHelper::" + queryType + "(). The value of '"
-                                         + it->field + "' is not a supported data type.");
-            }
             throw std::runtime_error("Error binding " + queryType + " statement. SQLite3 error " + std::to_string(bindResult) + ": "
-                                     + std::string(sqlite3_errmsg(db)));
+                                     + sqliteMessage);
         }
         
-        index++;
+        index += numValues;
     }
 }
 
-void DBHelper::finalizeStatement(sqlite3_stmt *statement, const std::string &errorMessage) const
+void DBHelper::releaseStatement(DBConnection &connection, sqlite3_stmt *statement, const std::string &query, const std::string &errorMessage) const
 {
-    int finalizeResult = sqlite3_finalize(statement);
-    if (finalizeResult != SQLITE_OK)
+    // sqlite3_reset() returns the error of the last call to sqlite3_step(), if there was one.
+    // The statement can be reused either way.
+    int resetResult = sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+    if (resetResult != SQLITE_OK)
     {
-        throw std::runtime_error(errorMessage + " SQLite3 error " + std::to_string(finalizeResult) + ": "
-                                 + std::string(sqlite3_errmsg(db)));
+        std::string sqliteMessage = sqlite3_errmsg(connection.getHandle());
+        connection.getStatementCache().release(query, statement);
+        throw std::runtime_error(errorMessage + " SQLite3 error " + std::to_string(resetResult) + ": " + sqliteMessage);
     }
+    
+    connection.getStatementCache().release(query, statement);
 }
 
-void DBHelper::openDB()
+void DBHelper::openDB(const DBConfig &config)
 {
-    const char* file_name = "sql/data.db";
-    int result;
-    result = sqlite3_open(file_name, &db);
-    if (result != SQLITE_OK) {
+    // One connection per core lets read-only queries from different sessions run in parallel.
+    int poolSize = config.poolSize;
+    if (poolSize == 0)
+    {
+        poolSize = std::max(4, (int)std::thread::hardware_concurrency());
+    }
+    pool = new DBConnectionPool(config, poolSize);
+    
+    // Runs before any query, so the queries never see an older schema than the one they were written for.
+    try
+    {
+        DBConnectionPool::Lease connection = pool->acquire();
+        SchemaMigrator().migrate(connection->getHandle());
+        deleteStaleCarts(*connection);
+    }
+    catch (...)
+    {
         closeDB();
-        throw std::runtime_error("Error opening database. SQLite3 error " + std::to_string(result) + ": "
-                                 + std::string(sqlite3_errmsg(db)));
+        throw;
     }
 }
 
-void DBHelper::closeDB()
+void DBHelper::deleteStaleCarts(DBConnection &connection) const
 {
-    int result;
-    result = sqlite3_close(db);
-    if (result != SQLITE_OK)
+    // Only carts that are at least a day old, since another process using the database may still have sessions with carts.
+    std::string staleCarts = "SELECT orderNumber FROM OrderMaster WHERE status='cart' AND orderDate < DATETIME('now','localtime','-1 day')";
+    execute(connection, "BEGIN IMMEDIATE;", "deleteStaleCarts");
+    try
+    {
+        execute(connection, "DELETE FROM OrderDetail WHERE orderNumber IN (" + staleCarts + ");", "deleteStaleCarts");
+        execute(connection, "DELETE FROM OrderMaster WHERE orderNumber IN (" + staleCarts + ");", "deleteStaleCarts");
+        execute(connection, "COMMIT;", "deleteStaleCarts");
+    }
+    catch (...)
     {
-        throw std::runtime_error("Error closing database. SQLite3 error " + std::to_string(result) + ": "
-                                 + std::string(sqlite3_errmsg(db)));
+        sqlite3_exec(connection.getHandle(), "ROLLBACK;", NULL, NULL, NULL);
+        throw;
     }
 }
+
+void DBHelper::closeDB()
+{
+    delete pool;
+    pool = NULL;
+}
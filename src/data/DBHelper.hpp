@@ -12,16 +12,29 @@
 #include <map>
 #include <typeinfo>
 #include <iostream>
+#include <mutex>
+#include <functional>
+#include <tuple>
+#include <utility>
 
 #include "sqlite3.h"
 
 #include "Model.hpp"
+#include "Schema.hpp"
+#include "SqlAggregate.hpp"
 #include "SqlCondition.hpp"
+#include "SqlPage.hpp"
+#include "StatementCache.hpp"
+#include "DBConfig.hpp"
+#include "DBConnection.hpp"
+#include "DBConnectionPool.hpp"
 
 /**
  * @brief Data access layer class.
  *
  * Provides an abstract interface for accessing the SQLite3 database.
+ * Safe to use from multiple threads. Each call checks a connection out of a DBConnectionPool, so queries from different
+ * Wt sessions run on different connections in parallel.
  *
  * @author Julian Koksal
  * @date 2022-09-25
@@ -32,41 +45,156 @@ public:
     /**
      * @brief Gets the singleton instance of this class.
      *
+     * Thread-safe. The instance is created by the first call.
+     *
      * @return singleton instance of DBHelper
      */
     static const DBHelper & getInstance();
     
+    /**
+     * @brief Sets the settings the database will be opened with.
+     *
+     * Must be called before the first call to DBHelper::getInstance(), otherwise a runtime exception is thrown.
+     * If it is never called, the default DBConfig is used.
+     *
+     * @param config the database file and pragma settings
+     */
+    static void configure(const DBConfig &config);
+    
     /**
      * @brief Reads rows from the table represented by model and returns the result as a vector.
      *
-     * Casts the results of DBHelper::selectWhereHelper() to type T, which is the subclass of Model that the model parameter was.
-     * Conditions, sorting, and projection can be specified with the parameters, but are optional.
+     * Each result row is read straight into an object of type T, which is the subclass of Model that the model parameter was,
+     * using the compile-time schema of T.
+     * Conditions, sorting, projection, and paging can be specified with the parameters, but are optional.
      * If no optional parameters are given, returns all rows and columns of the table unsorted.
      *
+     * To process a large result one row at a time, without holding all of it in memory, use DBHelper::forEachWhere() instead.
+     *
      * @param model Must inherit from Model. Used to determine the table name, column names and types, and to cast the results.
      *              In the results, columns that are not selected will have the same value as in this object.
      * @param conditions Used to generate the WHERE clause of the select statement.
      * @param orderBy The field and direction used to generate the ORDER BY clause of the select statement. e.g. "price DESC".
      * @param columns The set of column names to select. If empty, all columns are selected.
+     * @param page The page of the result to read, used to generate the LIMIT and OFFSET clauses and the keyset comparison.
+     *             If not given, all rows are read. A keyset page must be sorted by its cursor columns, see SqlPage.
      * @return The result of the select statement as a vector of models.
      */
     template<class T, class = std::enable_if_t<std::is_base_of<Model, T>::value>>
     std::vector<T> selectWhere(const T &model, const std::vector<SqlCondition> &conditions = { }, const std::string &orderBy = "",
-                               const std::set<std::string> &columns = { }) const
+                               const std::set<std::string> &columns = { }, const SqlPage &page = SqlPage()) const
     {
         std::vector<T> result;
-        // Helper reads from the database.
-        std::vector<Model *> helperResult = selectWhereHelper(model, conditions, orderBy, columns);
-        // Converts the results to static T objects and deletes the dynamic objects created by selectWhereHelper().
-        for (std::vector<Model *>::iterator it = helperResult.begin(); it != helperResult.end(); it++)
+        if (page.limit > 0)
+        {
+            result.reserve(page.limit);
+        }
+        forEachWhere(model, conditions, [&result](const T &row) { result.push_back(row); }, orderBy, columns, page);
+        return result;
+    }
+    
+    /**
+     * @brief Reads rows from the table represented by model, calling callback with each row as it is read.
+     *
+     * Rows are read one at a time from sqlite3_step(), so memory use stays the same no matter how many rows match.
+     * Every row is read into the same object, which is only valid until callback returns. Copy it to keep it.
+     * Columns that are not selected are not reset between rows, so callback should not change them.
+     * Conditions, sorting, projection, and paging are the same as in DBHelper::selectWhere().
+     *
+     * The statement stays open on the calling thread's connection until the last row has been read. callback may use DBHelper,
+     * but it runs on that same connection. If callback throws, the query is stopped and the exception is passed on.
+     *
+     * @param model Must inherit from Model. Used to determine the table name, column names and types.
+     *              Columns that are not selected will have the same value as in this object.
+     * @param conditions Used to generate the WHERE clause of the select statement.
+     * @param callback Called with each row of the result, as a T&.
+     * @param orderBy The field and direction used to generate the ORDER BY clause of the select statement. e.g. "price DESC".
+     * @param columns The set of column names to select. If empty, all columns are selected.
+     * @param page The page of the result to read. If not given, all rows are read.
+     * @return the number of rows read
+     */
+    template<class T, class F, class = std::enable_if_t<std::is_base_of<Model, T>::value>>
+    long long forEachWhere(const T &model, const std::vector<SqlCondition> &conditions, F callback, const std::string &orderBy = "",
+                           const std::set<std::string> &columns = { }, const SqlPage &page = SqlPage()) const
+    {
+        T row = model;
+        return forEachWhereHelper(model, conditions, orderBy, columns, page, row, [&callback, &row]() { callback(row); });
+    }
+    
+    /**
+     * @brief Counts the rows of the table represented by model that match the conditions.
+     *
+     * Runs as SELECT COUNT(*), so no rows are read into memory.
+     *
+     * @param model Used to determine the table name.
+     * @param conditions Used to generate the WHERE clause of the select statement. If empty, all rows are counted.
+     * @return the number of matching rows
+     */
+    long long count(const Model &model, const std::vector<SqlCondition> &conditions = { }) const;
+    
+    /**
+     * @brief Checks if any row of the table represented by model matches the conditions.
+     *
+     * Runs as SELECT EXISTS, which stops at the first matching row.
+     *
+     * @param model Used to determine the table name.
+     * @param conditions Used to generate the WHERE clause of the select statement. If empty, checks if the table has any rows.
+     * @return true if at least one row matches
+     */
+    bool exists(const Model &model, const std::vector<SqlCondition> &conditions = { }) const;
+    
+    /**
+     * @brief Runs an aggregate query on the table represented by model, returning one tuple per result row.
+     *
+     * Each SqlAggregate is one result column, read into the tuple element of the same position. Ts must be bool, int, long long,
+     * double, or std::string. An aggregate of no rows, e.g. the SUM of an empty table, is NULL and is read as 0.
+     *
+     * Example, the total quantity ordered of each menu item:
+     *     std::vector<std::tuple<std::string, long long>> totals = db.aggregate<std::string, long long>(OrderDetail(),
+     *         { SqlAggregate("menuItemName"), SqlAggregate("SUM", "quantity") }, { }, "menuItemName");
+     *
+     * Throws a runtime exception if the number of aggregates is not the same as the number of Ts.
+     *
+     * @param model Used to determine the table name.
+     * @param aggregates The result columns.
+     * @param conditions Used to generate the WHERE clause of the select statement.
+     * @param groupBy The columns used to generate the GROUP BY clause, e.g. "menuItemName". The result is sorted the same way.
+     *                If empty, the result is one row.
+     * @return the result rows
+     */
+    template<class... Ts>
+    std::vector<std::tuple<Ts...>> aggregate(const Model &model, const std::vector<SqlAggregate> &aggregates,
+                                             const std::vector<SqlCondition> &conditions = { }, const std::string &groupBy = "") const
+    {
+        if (aggregates.size() != sizeof...(Ts))
         {
-            T *row = (T *)*it;
-            result.push_back(*row);
-            delete row;
+            throw std::runtime_error("Error in call to DBHelper::aggregate(). There must be one aggregate for each result type.");
         }
+        
+        std::vector<std::tuple<Ts...>> result;
+        aggregateHelper(model, aggregates, conditions, groupBy, [&result](sqlite3_stmt *statement) {
+            result.emplace_back();
+            readTuple(statement, result.back(), std::index_sequence_for<Ts...>());
+        });
         return result;
     }
     
+    /**
+     * @brief Gets the query plan SQLite chooses for the select statement selectWhere() and forEachWhere() generate.
+     *
+     * Runs EXPLAIN QUERY PLAN on the statement, without binding the values of the conditions. Used to check that a query is
+     * answered with an index, e.g. "SEARCH OrderMaster USING INDEX OrderMasterStatusOrderDate (status=?)", rather than by
+     * reading the whole table, e.g. "SCAN OrderMaster".
+     *
+     * @param model Used to determine the table name and column names.
+     * @param conditions Used to generate the WHERE clause of the select statement.
+     * @param orderBy The field and direction used to generate the ORDER BY clause of the select statement. e.g. "price DESC".
+     * @param page The page of the result to read.
+     * @return the detail of each step of the plan, in order
+     */
+    std::vector<std::string> explainWhere(const Model &model, const std::vector<SqlCondition> &conditions = { },
+                                          const std::string &orderBy = "", const SqlPage &page = SqlPage()) const;
+    
     /**
      * @brief Inserts the given model to its associated table in the database.
      *
@@ -79,6 +207,28 @@ public:
      */
     long long insert(const Model &model) const;
     
+    /**
+     * @brief Inserts all of the given models to their associated table in the database.
+     *
+     * The statement is prepared once, then bound and run for each model, all inside one transaction.
+     * If any insert fails the whole batch is rolled back. If a transaction is already active, the batch joins it as a savepoint.
+     * Keys are handled the same as in DBHelper::insert().
+     *
+     * @param models The models to insert. Must inherit from Model.
+     * @return for each model, in order, the key of the inserted record if it has an autogenerated INTEGER PRIMARY KEY, 0 otherwise
+     */
+    template<class T, class = std::enable_if_t<std::is_base_of<Model, T>::value>>
+    std::vector<long long> insertMany(const std::vector<T> &models) const
+    {
+        std::vector<const Model *> modelPointers;
+        modelPointers.reserve(models.size());
+        for (typename std::vector<T>::const_iterator it = models.begin(); it != models.end(); it++)
+        {
+            modelPointers.push_back(&*it);
+        }
+        return insertManyHelper(modelPointers);
+    }
+    
     /**
      * @brief Updates the given model in the database by its primary key(s).
      *
@@ -123,28 +273,94 @@ public:
      */
     void destroyWhere(const Model &model, const std::vector<SqlCondition> &conditions) const;
     
+    /**
+     * @brief Begins a transaction on the calling thread.
+     *
+     * Until the matching call to DBHelper::commit() or DBHelper::rollback(), every call to DBHelper on this thread uses the same
+     * connection, so all of its statements are part of the transaction and are made durable by a single commit.
+     *
+     * The outermost transaction is started with BEGIN IMMEDIATE, taking the write lock up front so that a transaction which reads
+     * and then writes cannot fail part way through because another connection wrote first.
+     * Calls made while a transaction is already active create nested savepoints, which can be rolled back on their own.
+     *
+     * Prefer the Transaction class, which rolls back automatically if an exception is thrown.
+     */
+    void beginTransaction() const;
+    
+    /**
+     * @brief Commits the innermost transaction or savepoint started on the calling thread.
+     *
+     * Throws a runtime exception if no transaction is active. If the outermost commit fails, the transaction is rolled back.
+     */
+    void commit() const;
+    
+    /**
+     * @brief Rolls back the innermost transaction or savepoint started on the calling thread.
+     *
+     * Throws a runtime exception if no transaction is active.
+     */
+    void rollback() const;
+    
+    /**
+     * @brief Gets the number of transactions and savepoints active on the calling thread.
+     *
+     * @return 0 if no transaction is active, 1 inside a transaction, and 1 more for each nested savepoint
+     */
+    int getTransactionDepth() const;
+    
+    /**
+     * @brief Gets the hit/miss counters and the current size of the prepared statement caches.
+     *
+     * Each pooled connection has its own statement cache. The stats of all of them are added together.
+     *
+     * @return the statement cache stats
+     */
+    StatementCache::Stats getStatementCacheStats() const;
+    
 private:
+    /**
+     * @brief The settings the database is opened with.
+     */
+    static DBConfig config;
+    
+    /**
+     * @brief Ensures the singleton instance is only created once.
+     */
+    static std::once_flag instanceFlag;
+    
     /**
      * @brief Singleton instance of DBHelper.
      */
     static const DBHelper * instance;
     
     /**
-     * @brief SQLite3 database handle.
+     * @brief Pool of SQLite3 database connections.
+     */
+    DBConnectionPool *pool;
+    
+    /**
+     * @brief The connection the calling thread's transaction is running on.
+     *
+     * Holding the lease keeps the connection checked out to the thread, so every DBHelper call made during the transaction uses it.
+     */
+    static thread_local DBConnectionPool::Lease transactionConnection;
+    
+    /**
+     * @brief The number of transactions and savepoints active on the calling thread.
      */
-    sqlite3* db;
+    static thread_local int transactionDepth;
     
     /**
      * @brief Constructor.
      *
-     * Opens the SQLite3 database handle using the file "sql/data.db".
+     * Creates the connection pool using the settings given to DBHelper::configure().
      */
     DBHelper();
     
     /**
      * @brief Destructor.
      *
-     * Closes the sqlite3 database handle.
+     * Closes the connection pool.
      */
     ~DBHelper();
     
@@ -163,38 +379,143 @@ private:
     DBHelper& operator=(const DBHelper &other);
     
     /**
-     * @brief Reads rows from the table represented by model and returns the result as a vector.
+     * @brief Reads rows from the table represented by model into row, calling onRow after each one.
      *
      * Conditions, sorting, and projection can be specified with the parameters, but are optional.
-     * Returns all rows and columns of the table, unsorted, if no optional parameters are given.
+     * Reads all rows and columns of the table, unsorted, if no optional parameters are given.
      *
-     * Used only by DBHelper::selectWhere().
-     * Its purpose is to keep most of the implementation of DBHelper::selectWhere() (a template function) outside of the header file.
+     * Used only by DBHelper::forEachWhere().
+     * Its purpose is to keep most of the implementation of DBHelper::forEachWhere() (a template function) outside of the header file.
      *
-     * @param model Used to determine the table name, column names and types, and to cast the results.
+     * @param model Used to determine the table name and column names.
      * @param conditions Used to generate the WHERE clause of the select statement.
      * @param orderBy The field and direction used to generate the ORDER BY clause of the select statement. e.g. "price DESC".
      * @param columns The set of column names to select. If empty, all columns are selected.
-     * @return The result of the select statement as a vector of Model pointers.
+     * @param page The page of the result to read.
+     * @param row The object each result row is read into. Columns that are not selected are left unchanged.
+     * @param onRow Called after each result row has been read into row.
+     * @return the number of rows read
+     */
+    long long forEachWhereHelper(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
+                                 const std::set<std::string> &columns, const SqlPage &page, Model &row,
+                                 const std::function<void()> &onRow) const;
+    
+    /**
+     * @brief Generates the select statement of selectWhere(), forEachWhere(), and explainWhere().
+     *
+     * @param model Used to determine the table name and column names.
+     * @param conditions Used to generate the WHERE clause of the select statement.
+     * @param orderBy The field and direction used to generate the ORDER BY clause of the select statement.
+     * @param columnsToSelect The indexes of the columns to select, in model.columns().
+     * @param page The page of the result to read. Adds the cursor comparison and the LIMIT and OFFSET parameters.
+     * @return the select statement, with a parameter for each condition, each cursor column, and the limit and offset
      */
-    std::vector<Model *> selectWhereHelper(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
-                                           const std::set<std::string> &columns) const;
+    std::string generateSelectQuery(const Model &model, const std::vector<SqlCondition> &conditions, const std::string &orderBy,
+                                    const std::vector<int> &columnsToSelect, const SqlPage &page) const;
+    
+    /**
+     * @brief Runs an aggregate query on the table represented by model, calling onRow with the statement at each result row.
+     *
+     * Used only by DBHelper::aggregate().
+     * Its purpose is to keep most of the implementation of DBHelper::aggregate() (a template function) outside of the header file.
+     *
+     * @param model Used to determine the table name.
+     * @param aggregates The result columns.
+     * @param conditions Used to generate the WHERE clause of the select statement.
+     * @param groupBy The columns used to generate the GROUP BY and ORDER BY clauses.
+     * @param onRow Called with the statement after each step that returned a row.
+     */
+    void aggregateHelper(const Model &model, const std::vector<SqlAggregate> &aggregates, const std::vector<SqlCondition> &conditions,
+                         const std::string &groupBy, const std::function<void(sqlite3_stmt *)> &onRow) const;
+    
+    /**
+     * @brief Prepares a select query, binds the conditions to it, and calls onRow with the statement at each result row.
+     *
+     * @param query the select query, with a parameter for each condition
+     * @param conditions the conditions to bind the values of
+     * @param queryType the type of query (count, exists, etc), used to generate error messages
+     * @param onRow Called with the statement after each step that returned a row.
+     */
+    void forEachResultRow(const std::string &query, const std::vector<SqlCondition> &conditions, const std::string &queryType,
+                          const std::function<void(sqlite3_stmt *)> &onRow) const;
+    
+    /**
+     * @brief Reads the result columns of the statement's current row into the elements of row, in order.
+     *
+     * @param statement the statement that has a result row
+     * @param row the tuple to read into
+     */
+    template<class Tuple, std::size_t... Is>
+    static void readTuple(sqlite3_stmt *statement, Tuple &row, std::index_sequence<Is...>)
+    {
+        (Schema::readValue(statement, (int)Is, std::get<Is>(row)), ...);
+    }
+    
+    /**
+     * @brief Inserts the given models, which must all be of the same class, in one transaction.
+     *
+     * Used only by DBHelper::insertMany().
+     * Its purpose is to keep most of the implementation of DBHelper::insertMany() (a template function) outside of the header file.
+     *
+     * @param models the models to insert
+     * @return for each model, the key of the inserted record if it has an autogenerated INTEGER PRIMARY KEY, 0 otherwise
+     */
+    std::vector<long long> insertManyHelper(const std::vector<const Model *> &models) const;
+    
+    /**
+     * @brief Generates the INSERT statement for the table that model represents.
+     *
+     * The columns are listed by name, so the order of the columns in the SQL table does not matter.
+     *
+     * @param model used to determine the table name and column names
+     * @param columns the indexes of the columns to insert, as given by DBHelper::generateInsertColumns()
+     * @return the INSERT query, with a parameter for each column
+     */
+    std::string generateInsertQuery(const Model &model, const std::vector<int> &columns) const;
+    
+    /**
+     * @brief Gets the indexes of the columns that are given values when inserting model.
+     *
+     * That is every column, except for the key if it is an autogenerated INTEGER PRIMARY KEY.
+     * Leaving the key out of the insert lets SQLite3 automatically choose a unique value for it.
+     *
+     * @param model used to determine the columns and keys
+     * @return the indexes of the columns in model.columns()
+     */
+    std::vector<int> generateInsertColumns(const Model &model) const;
     
     /**
      * @brief Prepares a sqlite3 statement from the given query.
      *
+     * Reuses a statement from the statement cache if one was already prepared from the same query.
+     * The statement must be given back with DBHelper::releaseStatement().
+     *
+     * @param connection the connection to prepare the statement on
      * @param query the query used to prepare the statement
      * @param queryType the type of query (select, insert, etc), used to generate error messages
      */
-    sqlite3_stmt * prepareStatement(const std::string &query, const std::string &queryType) const;
+    sqlite3_stmt * prepareStatement(DBConnection &connection, const std::string &query, const std::string &queryType) const;
+    
+    /**
+     * @brief Prepares, runs, and releases a statement that has no parameters and returns no rows.
+     *
+     * Used for transaction control statements, e.g. "COMMIT;".
+     *
+     * @param connection the connection to run the statement on
+     * @param query the statement to run
+     * @param queryType the type of query, used to generate error messages
+     */
+    void execute(DBConnection &connection, const std::string &query, const std::string &queryType) const;
     
     /**
-     * @brief Generates the WHERE clause of a query from a vector of SqlCondition objects.
+     * @brief Appends the WHERE clause of a query, generated from a vector of SqlCondition objects joined with AND, to the query.
+     *
+     * Appends in place, so no temporary strings are allocated.
      *
+     * @param query the query to append to
      * @param conditions iterated to generate the WHERE clause
-     * @return the WHERE clause of a query
      */
-    std::string generateWhereClauseFromConditions(const std::vector<SqlCondition> &conditions) const;
+    void appendWhereClauseFromConditions(std::string &query, const std::vector<SqlCondition> &conditions) const;
     
     /**
      * @brief Generates the WHERE clause of a query from a vector of key column names.
@@ -211,17 +532,18 @@ private:
      *
      * @param statement the sqlite3 statement to bind
      * @param model the model to get values from
-     * @param columns the names of the columns to bind the values of
+     * @param columns the indexes in model.columns() of the columns to bind the values of
      * @param index the sqlite3 statement parameter index
      * @param queryType the type of query (select, insert, etc), used to generate error messages
      */
-    void bindStatementColumns(sqlite3_stmt *statement, const Model &model, const std::vector<std::string> &columns, int &index,
+    void bindStatementColumns(sqlite3_stmt *statement, const Model &model, const std::vector<int> &columns, int &index,
                        const std::string &queryType) const;
     
     /**
      * @brief Iterates the conditions and binds their values to the statement, starting at index.
      *
      * Index is incremented with each iteration to allow multiple uses of bind statement methods on the same statement.
+     * The values of combined conditions are bound depth first, in the same order appendWhereClauseFromConditions() generates them.
      *
      * @param statement the sqlite3 statement to bind
      * @param conditions the conditions to bind the values of
@@ -232,24 +554,42 @@ private:
                        const std::string &queryType) const;
     
     /**
-     * @brief Finalizes the statement.
+     * @brief Resets the statement and returns it to the statement cache.
      *
-     * Runs the destructor for statement, preventing resource leaks.
+     * Clears the bindings so that the statement can be reused.
+     * If running the statement failed, the statement is still cached and a runtime exception is thrown.
      *
-     * @param statement the sqlite3 statement to finalize
+     * @param connection the connection the statement was prepared on
+     * @param statement the sqlite3 statement to release
+     * @param query the query the statement was prepared from
      * @param errorMessage the message to print if an error occurred when running the statement
      */
-    void finalizeStatement(sqlite3_stmt *statement, const std::string &errorMessage) const;
+    void releaseStatement(DBConnection &connection, sqlite3_stmt *statement, const std::string &query, const std::string &errorMessage) const;
     
     /**
-     * @brief Opens the sqlite3 database handle.
+     * @brief Creates the connection pool, upgrades the database to the latest schema version with SchemaMigrator, and deletes
+     * stale carts.
+     *
+     * Connections to config.path are opened by the pool as they are needed, each with the pragmas from config applied.
+     * Throws a runtime exception if the schema could not be upgraded.
+     *
+     * @param config the database file and pragma settings
+     */
+    void openDB(const DBConfig &config);
+    
+    /**
+     * @brief Deletes the carts that were left in the database by sessions that ended without checking out, e.g. in a crash.
+     *
+     * A cart is only read by the session that wrote it, so a cart whose session has ended is never used again. Carts created
+     * less than a day ago are kept, since their sessions may still be running in another process.
+     * Throws a runtime exception if the carts could not be deleted.
      *
-     * Opens the SQLite3 database handle using the file "sql/data.db".
+     * @param connection the connection to delete them with, which must not be in a transaction
      */
-    void openDB();
+    void deleteStaleCarts(DBConnection &connection) const;
     
     /**
-     * @brief Closes the sqlite3 database handle.
+     * @brief Closes every connection in the pool.
      *
      * Prevents resource leaks.
      */
@@ -44,7 +44,7 @@ std::string InventoryItem::tableName() const
 
 std::vector<std::string> InventoryItem::columns() const
 {
-    return { "itemID", "itemName", "quantity" };
+    return Schema::names(schema());
 }
 
 std::set<std::string> InventoryItem::keys() const
@@ -57,23 +57,12 @@ bool InventoryItem::isAutoGeneratedKey() const
     return true;
 }
 
-std::map<std::string, std::any> InventoryItem:: toMap() const
+int InventoryItem::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = itemID;
-    mMap[columns()[1]] = itemName;
-    mMap[columns()[2]] = quantity;
-
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * InventoryItem::fromMap(std::map<std::string, std::any> mMap) const
+void InventoryItem::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-
-    int mID = std::any_cast<int>(mMap[columns()[0]]);
-    std::string mName = std::any_cast<std::string>(mMap[columns()[1]]);
-    int mQuantity = std::any_cast<int>(mMap[columns()[2]]);
-    InventoryItem *model = new InventoryItem(mID, mName, mQuantity);
-
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
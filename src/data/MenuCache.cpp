@@ -0,0 +1,117 @@
+//
+//  MenuCache.cpp
+//
+
+#include "MenuCache.hpp"
+
+#include <functional>
+
+#include "DBHelper.hpp"
+
+MenuSnapshot::MenuSnapshot(long long version, const std::vector<MenuItem> &items)
+{
+    this->version = version;
+    this->items = items;
+
+    for (std::vector<MenuItem>::iterator it = this->items.begin(); it != this->items.end(); it++)
+    {
+        names.push_back(it->getName());
+        prices.push_back(it->getPrice());
+    }
+
+    std::size_t numSlots = 8;
+    while (numSlots < names.size() * 2)
+    {
+        numSlots *= 2;
+    }
+    slots.assign(numSlots, -1);
+
+    for (int i = 0; i < names.size(); i++)
+    {
+        std::size_t slot = std::hash<std::string>()(names[i]) & (numSlots - 1);
+        while (slots[slot] != -1)
+        {
+            slot = (slot + 1) & (numSlots - 1);
+        }
+        slots[slot] = i;
+    }
+}
+
+long long MenuSnapshot::getVersion() const
+{
+    return version;
+}
+
+const std::vector<MenuItem> & MenuSnapshot::getItems() const
+{
+    return items;
+}
+
+int MenuSnapshot::find(const std::string &name) const
+{
+    // At most half of the slots are used, so an empty slot always ends the probe.
+    std::size_t slot = std::hash<std::string>()(name) & (slots.size() - 1);
+    while (slots[slot] != -1)
+    {
+        if (names[slots[slot]] == name)
+        {
+            return slots[slot];
+        }
+        slot = (slot + 1) & (slots.size() - 1);
+    }
+    return -1;
+}
+
+bool MenuSnapshot::getPrice(const std::string &name, double &price) const
+{
+    int index = find(name);
+    if (index == -1)
+    {
+        return false;
+    }
+    price = prices[index];
+    return true;
+}
+
+MenuCache * MenuCache::instance = NULL;
+
+std::once_flag MenuCache::instanceFlag;
+
+MenuCache::MenuCache()
+{
+    version = 0;
+}
+
+MenuCache & MenuCache::getInstance()
+{
+    std::call_once(instanceFlag, [] { instance = new MenuCache(); });
+    return *instance;
+}
+
+std::shared_ptr<const MenuSnapshot> MenuCache::get()
+{
+    std::shared_ptr<const MenuSnapshot> current = std::atomic_load(&snapshot);
+    if (current != NULL)
+    {
+        return current;
+    }
+
+    // Only the first readers get here. One reads the menu while the others wait for it.
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    current = std::atomic_load(&snapshot);
+    if (current == NULL)
+    {
+        current = std::make_shared<const MenuSnapshot>(++version, DBHelper::getInstance().selectWhere(MenuItem()));
+        std::atomic_store(&snapshot, current);
+    }
+    return current;
+}
+
+std::shared_ptr<const MenuSnapshot> MenuCache::reload()
+{
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    std::shared_ptr<const MenuSnapshot> current = std::make_shared<const MenuSnapshot>(++version,
+                                                                                       DBHelper::getInstance().selectWhere(MenuItem()));
+    std::atomic_store(&snapshot, current);
+    return current;
+}
@@ -0,0 +1,176 @@
+//
+//  MenuCache.hpp
+//
+
+#ifndef MenuCache_hpp
+#define MenuCache_hpp
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+
+#include "MenuItem.hpp"
+
+/**
+ * @brief The menu as it was when it was read from the database. Never changes once built.
+ */
+class MenuSnapshot
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * Builds the name index of the items.
+     *
+     * @param version the version of the menu
+     * @param items the menu items, in the order they are shown
+     */
+    MenuSnapshot(long long version, const std::vector<MenuItem> &items);
+
+    /**
+     * @brief Gets the version of the menu. Each snapshot built by MenuCache has a higher version than the one before it.
+     *
+     * @return version
+     */
+    long long getVersion() const;
+
+    /**
+     * @brief Gets the menu items, in the order they are shown.
+     *
+     * @return vector of menu items
+     */
+    const std::vector<MenuItem> & getItems() const;
+
+    /**
+     * @brief Finds a menu item by name.
+     *
+     * @param name the name of the menu item
+     * @return the index of the item in getItems(), or -1 if it is not on the menu
+     */
+    int find(const std::string &name) const;
+
+    /**
+     * @brief Gets the price of a menu item.
+     *
+     * @param name the name of the menu item
+     * @param price set to the price of the item, if it is on the menu
+     * @return true if the item is on the menu
+     */
+    bool getPrice(const std::string &name, double &price) const;
+
+private:
+    /**
+     * @brief The version of the menu.
+     */
+    long long version;
+
+    /**
+     * @brief The menu items, in the order they are shown.
+     */
+    std::vector<MenuItem> items;
+
+    /**
+     * @brief The name of each item, in the same order as items.
+     */
+    std::vector<std::string> names;
+
+    /**
+     * @brief The price of each item, in the same order as items.
+     */
+    std::vector<double> prices;
+
+    /**
+     * @brief Open addressing hash table of indexes into items, -1 for an empty slot.
+     *
+     * Its size is a power of two at least twice the number of items, so a lookup probes only a few slots.
+     */
+    std::vector<int> slots;
+};
+
+/**
+ * @brief Process-wide cache of the menu.
+ *
+ * The menu is read on every page that shows it but rarely changes, so it is read once into a MenuSnapshot that every session
+ * shares. get() takes no lock: it atomically loads the current snapshot, which stays valid for as long as the caller holds it.
+ *
+ * After the menu is changed in the database, reload() reads it again and atomically swaps in the new snapshot. Sessions that are
+ * still using the old snapshot keep it until they let go of it.
+ *
+ * Thread-safe.
+ */
+class MenuCache
+{
+public:
+    /**
+     * @brief Gets the singleton instance of this class.
+     *
+     * @return singleton instance of MenuCache
+     */
+    static MenuCache & getInstance();
+
+    /**
+     * @brief Gets the current menu.
+     *
+     * Reads the menu from the database if it has not been read yet.
+     *
+     * @return the snapshot
+     */
+    std::shared_ptr<const MenuSnapshot> get();
+
+    /**
+     * @brief Reads the menu from the database and replaces the current snapshot.
+     *
+     * Should be called after a menu item is added, changed, or removed.
+     *
+     * @return the new snapshot
+     */
+    std::shared_ptr<const MenuSnapshot> reload();
+
+private:
+    /**
+     * @brief Singleton instance of MenuCache.
+     */
+    static MenuCache *instance;
+
+    /**
+     * @brief Ensures the singleton instance is only created once.
+     */
+    static std::once_flag instanceFlag;
+
+    /**
+     * @brief Held while the menu is read, so that snapshots are swapped in the order they were read.
+     */
+    std::mutex reloadMutex;
+
+    /**
+     * @brief The current snapshot, NULL until the menu is first read. Only accessed with std::atomic_load and std::atomic_store.
+     */
+    std::shared_ptr<const MenuSnapshot> snapshot;
+
+    /**
+     * @brief The version of the last snapshot built.
+     */
+    long long version;
+
+    /**
+     * @brief Constructor.
+     */
+    MenuCache();
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented to prevent copying of singleton instance.
+     */
+    MenuCache(const MenuCache &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented to prevent assignment of singleton instance.
+     */
+    MenuCache& operator=(const MenuCache &other);
+};
+
+#endif /* MenuCache_hpp */
@@ -51,7 +51,7 @@ std::string MenuItem::tableName() const
 
 std::vector<std::string> MenuItem::columns() const
 {
-    return { "name", "price", "description" };
+    return Schema::names(schema());
 }
 
 std::set<std::string> MenuItem::keys() const
@@ -64,22 +64,12 @@ bool MenuItem::isAutoGeneratedKey() const
     return false;
 }
 
-std::map<std::string, std::any> MenuItem::toMap() const
+int MenuItem::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = name;
-    mMap[columns()[1]] = price;
-    mMap[columns()[2]] = description;
-    
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * MenuItem::fromMap(std::map<std::string, std::any> mMap) const
+void MenuItem::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-    std::string mName = std::any_cast<std::string>(mMap[columns()[0]]);
-    double mPrice = std::any_cast<double>(mMap[columns()[1]]);
-    std::string mDescription = std::any_cast<std::string>(mMap[columns()[2]]);
-    
-    MenuItem *model = new MenuItem(mName, mPrice, mDescription);
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
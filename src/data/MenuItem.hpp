@@ -5,10 +5,11 @@
 #ifndef MenuItem_hpp
 #define MenuItem_hpp
 
-#include <map>
+#include <tuple>
 #include <string>
 
 #include "Model.hpp"
+#include "Schema.hpp"
 
 /**
  * @brief Class representing a row of the MenuItem table.
@@ -86,8 +87,16 @@ private:
     virtual std::vector<std::string> columns() const override;
     virtual std::set<std::string> keys() const override;
     virtual bool isAutoGeneratedKey() const override;
-    virtual std::map<std::string, std::any> toMap() const override;
-    virtual Model * fromMap(std::map<std::string, std::any> mMap) const override;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const override;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) override;
+    
+    /** The columns of the table, in order, and the member variables that hold their values. */
+    static constexpr auto schema()
+    {
+        return std::make_tuple(Schema::column("name", &MenuItem::name),
+                               Schema::column("price", &MenuItem::price),
+                               Schema::column("description", &MenuItem::description));
+    }
 };
 
 #endif /* MenuItem_hpp */
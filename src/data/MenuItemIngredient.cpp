@@ -43,7 +43,7 @@ std::string MenuItemIngredient::tableName() const
 
 std::vector<std::string> MenuItemIngredient::columns() const
 {
-    return { "inventoryItemID", "menuItemName", "quantity" };
+    return Schema::names(schema());
 }
 
 std::set<std::string> MenuItemIngredient::keys() const
@@ -56,22 +56,12 @@ bool MenuItemIngredient::isAutoGeneratedKey() const
     return false;
 }
 
-std::map<std::string, std::any> MenuItemIngredient:: toMap() const
+int MenuItemIngredient::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = inventoryItemID;
-    mMap[columns()[1]] = menuItemName;
-    mMap[columns()[2]] = quantity;
-
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * MenuItemIngredient::fromMap(std::map<std::string, std::any> mMap) const
+void MenuItemIngredient::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-    int mID = std::any_cast<int>(mMap[columns()[0]]);
-    std::string mName = std::any_cast<std::string>(mMap[columns()[1]]);
-    int mQuantity = std::any_cast<int>(mMap[columns()[2]]);
-    MenuItemIngredient *model = new MenuItemIngredient(mName, mID, mQuantity);
-
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
@@ -2,9 +2,10 @@
 #define menuItemIngredient_hpp
 
 #include <string>
-#include <map>
+#include <tuple>
 
 #include "Model.hpp"
+#include "Schema.hpp"
 
 /**
  * @brief represents a row of the MenuItemIngredient table in the SQL database
@@ -76,13 +77,21 @@ private:
      */
     int quantity;
 
-    /** override virtual method of the model to set up the new table name, columns, keys, toMap, etc*/
+    /** override virtual method of the model to set up the new table name, columns, keys, schema, etc*/
     virtual std::string tableName() const override;
     virtual std::vector<std::string> columns() const override;
     virtual std::set<std::string> keys() const override;
     virtual bool isAutoGeneratedKey() const override;
-    virtual std::map<std::string, std::any> toMap() const override;
-    virtual Model * fromMap(std::map<std::string, std::any> mMap) const override;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const override;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) override;
+    
+    /** The columns of the table, in order, and the member variables that hold their values. */
+    static constexpr auto schema()
+    {
+        return std::make_tuple(Schema::column("menuItemName", &MenuItemIngredient::menuItemName),
+                               Schema::column("inventoryItemID", &MenuItemIngredient::inventoryItemID),
+                               Schema::column("quantity", &MenuItemIngredient::quantity));
+    }
 };
 
 
@@ -6,16 +6,17 @@
 #define Model_hpp
 
 #include <string>
-#include <any>
 #include <set>
-#include <map>
 #include <vector>
 
+#include "sqlite3.h"
+
 /**
  * @brief Abstract class representing a row of a database table.
  *
  * Member variables represent the columns of the table.
- * Has private pure virtual methods to identify the table name, columns, primary keys, and if the key should be an autogenerated integer.
+ * Has private pure virtual methods to identify the table name, columns, primary keys, and if the key should be an autogenerated integer,
+ * and to bind and read the value of each column.
  * These methods provide an interface for DBHelper to use. When implemented in a subclass, they should always return the same values for that class.
  *
  * @author Julian Koksal
@@ -73,28 +74,32 @@ private:
     virtual bool isAutoGeneratedKey() const = 0;
     
     /**
-     * @brief Returns a map representation of this object.
+     * @brief Binds the value of one column of this object to a statement parameter.
      *
-     * For each member variable of this object the map has a key value pair where the key is the name of the member variable
-     * and the value is the value of the member variable.
+     * Subclasses implement this with Schema::bind() and the compile-time schema of their table, so the value is bound with the
+     * sqlite3 function for its type without any conversion.
      *
-     * @note Used by DBHelper to iterate the member variables of this object.
+     * @note Used by DBHelper to bind the member variables of this object.
      *
-     * @return a map representation of this object
+     * @param statement the statement to bind
+     * @param index the sqlite3 statement parameter index
+     * @param column the index of the column in columns()
+     * @return the result of the sqlite3 bind function
      */
-    virtual std::map<std::string, std::any> toMap() const = 0;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const = 0;
     
     /**
-     * @brief Returns a pointer to a new object with member variables initialized according to mMap.
+     * @brief Reads one column of a result row into the corresponding member variable of this object.
      *
-     * This is essentially the inverse of toMap(). mMap should be a map as described there.
+     * This is essentially the inverse of bindColumn(). Subclasses implement it with Schema::read().
      *
-     * @note Used by DBHelper to create an object from the SQLite3 API results.
+     * @note Used by DBHelper to fill in an object from the SQLite3 API results.
      *
-     * @param mMap a map representation of the object, as created by a call to toMap()
-     * @return pointer to the new model
+     * @param statement the statement that has a result row
+     * @param index the index of the result column
+     * @param column the index of the column in columns()
      */
-    virtual Model * fromMap(std::map<std::string, std::any> mMap) const = 0;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) = 0;
 };
 
 #endif /* Model_hpp */
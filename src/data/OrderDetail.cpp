@@ -47,7 +47,7 @@ std::string OrderDetail::tableName() const
 
 std::vector<std::string> OrderDetail::columns() const
 {
-    return { "orderDetailID", "orderNumber", "menuItemName", "quantity" };
+    return Schema::names(schema());
 }
 
 std::set<std::string> OrderDetail::keys() const
@@ -60,24 +60,12 @@ bool OrderDetail::isAutoGeneratedKey() const
     return true;
 }
 
-std::map<std::string, std::any> OrderDetail:: toMap() const
+int OrderDetail::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = orderDetailID;
-    mMap[columns()[1]] = orderNumber;
-    mMap[columns()[2]] = menuItemName;
-    mMap[columns()[3]] = quantity;
-
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * OrderDetail::fromMap(std::map<std::string, std::any> mMap) const
+void OrderDetail::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-    int mOrderDetailID = std::any_cast<int>(mMap[columns()[0]]);
-    int mOrderNumber = std::any_cast<int>(mMap[columns()[1]]);
-    std::string mName = std::any_cast<std::string>(mMap[columns()[2]]);
-    int mQuantity = std::any_cast<int>(mMap[columns()[3]]);
-    OrderDetail *model = new OrderDetail(mOrderDetailID, mOrderNumber, mName, mQuantity);
-
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
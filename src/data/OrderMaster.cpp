@@ -69,7 +69,7 @@ std::string OrderMaster::tableName() const
 
 std::vector<std::string> OrderMaster::columns() const
 {
-    return {"orderNumber", "orderedBy", "orderDate", "status", "sessionID"};
+    return Schema::names(schema());
 }
 
 std::set<std::string> OrderMaster::keys() const
@@ -82,26 +82,12 @@ bool OrderMaster::isAutoGeneratedKey() const
     return true;
 }
 
-std::map<std::string, std::any> OrderMaster::toMap() const
+int OrderMaster::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = orderNumber;
-    mMap[columns()[1]] = orderedBy;
-    mMap[columns()[2]] = orderDate;
-    mMap[columns()[3]] = status;
-    mMap[columns()[4]] = sessionID;
-
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model *OrderMaster::fromMap(std::map<std::string, std::any> mMap) const
+void OrderMaster::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-    int mOrderNumber = std::any_cast<int>(mMap[columns()[0]]);
-    std::string mOrderedBy = std::any_cast<std::string>(mMap[columns()[1]]);
-    std::string mOrderDate = std::any_cast<std::string>(mMap[columns()[2]]);
-    std::string mStatus = std::any_cast<std::string>(mMap[columns()[3]]);
-    std::string mSessionID = std::any_cast<std::string>(mMap[columns()[4]]);
-
-    OrderMaster *model = new OrderMaster(mOrderNumber, mOrderedBy, mOrderDate, mStatus, mSessionID);
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
@@ -0,0 +1,163 @@
+//
+//  SalesCache.cpp
+//
+
+#include "SalesCache.hpp"
+
+#include <cstdio>
+#include <map>
+
+#include "DBHelper.hpp"
+#include "MenuCache.hpp"
+#include "vOrderSales.hpp"
+
+SalesCache * SalesCache::instance = NULL;
+
+std::once_flag SalesCache::instanceFlag;
+
+SalesCache::SalesCache()
+{
+    generation = 0;
+    snapshotGeneration = -1;
+}
+
+SalesCache & SalesCache::getInstance()
+{
+    std::call_once(instanceFlag, [] { instance = new SalesCache(); });
+    return *instance;
+}
+
+std::shared_ptr<const SalesCache::Snapshot> SalesCache::get(const std::string &firstDay, int numDays)
+{
+    std::shared_ptr<const MenuSnapshot> menu = MenuCache::getInstance().get();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (snapshot != NULL && snapshotGeneration == generation && snapshot->menuVersion == menu->getVersion()
+        && snapshot->firstDay == firstDay && snapshot->numDays == numDays)
+    {
+        return snapshot;
+    }
+
+    // Read before building, so that an invalidate() during the build makes the result out of date.
+    long long buildGeneration = generation;
+    snapshot = build(*menu, firstDay, numDays);
+    snapshotGeneration = buildGeneration;
+
+    return snapshot;
+}
+
+void SalesCache::invalidate()
+{
+    generation++;
+}
+
+std::shared_ptr<const SalesCache::Snapshot> SalesCache::build(const MenuSnapshot &menu, const std::string &firstDay, int numDays) const
+{
+    const DBHelper &db = DBHelper::getInstance();
+
+    std::shared_ptr<Snapshot> result = std::make_shared<Snapshot>();
+    result->firstDay = firstDay;
+    result->numDays = numDays;
+    result->menuVersion = menu.getVersion();
+
+    // The chart lists the menu items by name.
+    std::map<std::string, MenuItem> menuByName;
+    for (std::vector<MenuItem>::const_iterator it = menu.getItems().begin(); it != menu.getItems().end(); it++)
+    {
+        MenuItem item = *it;
+        menuByName[item.getName()] = item;
+    }
+    for (std::map<std::string, MenuItem>::iterator it = menuByName.begin(); it != menuByName.end(); it++)
+    {
+        result->menu.push_back(it->second);
+    }
+
+    int numSeries = (int)result->menu.size() + 1;
+    result->revenue.assign(numSeries, std::vector<double>(numDays, 0.0));
+    result->quantity.assign(numSeries, std::vector<int>(numDays, 0));
+    result->maxRevenue.assign(numSeries, 0.0);
+    result->maxQuantity.assign(numSeries, 0);
+
+    // Maps each menu item name to its series.
+    std::map<std::string, int> seriesIndexes;
+    seriesIndexes["All menu items"] = 0;
+    for (int i = 0; i < (int)result->menu.size(); i++)
+    {
+        seriesIndexes[result->menu[i].getName()] = i + 1;
+    }
+
+    int firstDayNumber = toDayNumber(firstDay);
+    std::vector<SqlCondition> conditions = { SqlCondition::between("salesDate", firstDay, fromDayNumber(firstDayNumber + numDays - 1)) };
+
+    // The rows are ordered by date, so each date is only converted to a day index once.
+    std::string salesDate;
+    int day = 0;
+
+    db.forEachWhere(vOrderSales(), conditions, [&result, &seriesIndexes, firstDayNumber, &salesDate, &day](vOrderSales &sales) {
+        // Menu items that are no longer on the menu are not charted.
+        std::map<std::string, int>::iterator series = seriesIndexes.find(sales.getMenuItemName());
+        if (series == seriesIndexes.end())
+        {
+            return;
+        }
+
+        if (sales.getSalesDate() != salesDate)
+        {
+            salesDate = sales.getSalesDate();
+            day = toDayNumber(salesDate) - firstDayNumber;
+        }
+
+        double totalRevenue = sales.getTotalRevenue();
+        int totalQuantity = sales.getTotalQuantity();
+
+        result->revenue[series->second][day] = totalRevenue;
+        result->quantity[series->second][day] = totalQuantity;
+
+        if (totalRevenue > result->maxRevenue[series->second])
+        {
+            result->maxRevenue[series->second] = totalRevenue;
+        }
+        if (totalQuantity > result->maxQuantity[series->second])
+        {
+            result->maxQuantity[series->second] = totalQuantity;
+        }
+    }, "salesDate");
+
+    return result;
+}
+
+int SalesCache::toDayNumber(const std::string &date)
+{
+    int year = std::stoi(date.substr(0, 4));
+    int month = std::stoi(date.substr(5, 2));
+    int day = std::stoi(date.substr(8, 2));
+
+    // Counts from 0000-03-01 so that the leap day is the last day of the year, then shifts to 1970-01-01.
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+    return era * 146097 + dayOfEra - 719468;
+}
+
+std::string SalesCache::fromDayNumber(int dayNumber)
+{
+    // The inverse of toDayNumber().
+    dayNumber += 719468;
+    int era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+    int dayOfEra = dayNumber - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthFromMarch = (5 * dayOfYear + 2) / 153;
+    int day = dayOfYear - (153 * monthFromMarch + 2) / 5 + 1;
+    int month = monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9;
+    int year = yearOfEra + era * 400 + (month <= 2);
+
+    // Sized for any int, although the years used are four digits.
+    char date[48];
+    std::snprintf(date, sizeof(date), "%04d-%02d-%02d 00:00:00", year, month, day);
+    return std::string(date);
+}
@@ -0,0 +1,173 @@
+//
+//  SalesCache.hpp
+//
+
+#ifndef SalesCache_hpp
+#define SalesCache_hpp
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+#include "MenuCache.hpp"
+#include "MenuItem.hpp"
+
+/**
+ * @brief Process-wide cache of the daily sales series charted by the sales page.
+ *
+ * Every session that opens the sales page needs the same totals for the same days. The first one reads them from vOrderSales
+ * into a Snapshot, and later ones share that snapshot without touching the database.
+ *
+ * A snapshot covers a range of days and the menu as it was in MenuCache when the snapshot was built. It is rebuilt when a
+ * different range is asked for, e.g. once the day has changed, when MenuCache has a newer version of the menu, or after
+ * invalidate() has been called.
+ *
+ * Orders are dated when they are checked out, and completing an order does not change the sales, so the range of days up to
+ * yesterday, which the sales page charts, only changes when the day does. Placing and completing orders does not invalidate it.
+ *
+ * Thread-safe. Snapshots are immutable, so a session can keep using its snapshot while a newer one is built.
+ */
+class SalesCache
+{
+public:
+    /**
+     * @brief The sales totals of each menu item for each day of a range.
+     *
+     * Series 0 is the total of all menu items, followed by one series per menu item in the same order as menu.
+     */
+    struct Snapshot
+    {
+        /** The first day of the range, formatted as "yyyy-MM-dd 00:00:00". */
+        std::string firstDay;
+
+        /** The number of days in the range. */
+        int numDays = 0;
+
+        /** The version of the MenuCache snapshot the menu was taken from. */
+        long long menuVersion = 0;
+
+        /** The menu, sorted by name. */
+        std::vector<MenuItem> menu;
+
+        /** Total revenue, indexed by series then day. */
+        std::vector<std::vector<double>> revenue;
+
+        /** Total quantity sold, indexed by series then day. */
+        std::vector<std::vector<int>> quantity;
+
+        /** The highest daily revenue of each series. */
+        std::vector<double> maxRevenue;
+
+        /** The highest daily quantity of each series. */
+        std::vector<int> maxQuantity;
+    };
+
+    /**
+     * @brief Gets the singleton instance of this class.
+     *
+     * @return singleton instance of SalesCache
+     */
+    static SalesCache & getInstance();
+
+    /**
+     * @brief Gets the sales of numDays days, starting at firstDay.
+     *
+     * Returns the cached snapshot if it covers the same days and has not been invalidated, otherwise reads a new one from the
+     * database. Only one thread reads at a time. Others asking for the same days wait for it and share the result.
+     *
+     * @param firstDay the first day, formatted as "yyyy-MM-dd 00:00:00"
+     * @param numDays the number of days
+     * @return the snapshot
+     */
+    std::shared_ptr<const Snapshot> get(const std::string &firstDay, int numDays);
+
+    /**
+     * @brief Marks the cached snapshot as out of date, so the next call to get() reads the sales again.
+     *
+     * Should be called after orders of past days are changed, e.g. by loading test data. Changes to the menu are noticed through
+     * MenuCache.
+     */
+    void invalidate();
+
+private:
+    /**
+     * @brief Singleton instance of SalesCache.
+     */
+    static SalesCache *instance;
+
+    /**
+     * @brief Ensures the singleton instance is only created once.
+     */
+    static std::once_flag instanceFlag;
+
+    /**
+     * @brief Held while the snapshot is read or rebuilt.
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief The most recently built snapshot, NULL if there is none.
+     */
+    std::shared_ptr<const Snapshot> snapshot;
+
+    /**
+     * @brief Increased by each call to invalidate().
+     */
+    std::atomic<long long> generation;
+
+    /**
+     * @brief The value of generation when snapshot started being built.
+     *
+     * If invalidate() is called while a snapshot is being built, the snapshot is already out of date when it is finished.
+     */
+    long long snapshotGeneration;
+
+    /**
+     * @brief Constructor.
+     */
+    SalesCache();
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented to prevent copying of singleton instance.
+     */
+    SalesCache(const SalesCache &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented to prevent assignment of singleton instance.
+     */
+    SalesCache& operator=(const SalesCache &other);
+
+    /**
+     * @brief Reads the sales of numDays days, starting at firstDay, from the database.
+     *
+     * @param menu the menu to chart
+     * @param firstDay the first day, formatted as "yyyy-MM-dd 00:00:00"
+     * @param numDays the number of days
+     * @return the new snapshot
+     */
+    std::shared_ptr<const Snapshot> build(const MenuSnapshot &menu, const std::string &firstDay, int numDays) const;
+
+    /**
+     * @brief Converts a date to the number of days since 1970-01-01.
+     *
+     * @param date the date, formatted as "yyyy-MM-dd", optionally followed by a time
+     * @return the day number
+     */
+    static int toDayNumber(const std::string &date);
+
+    /**
+     * @brief Converts a number of days since 1970-01-01 to a date.
+     *
+     * @param dayNumber the day number
+     * @return the date, formatted as "yyyy-MM-dd 00:00:00"
+     */
+    static std::string fromDayNumber(int dayNumber);
+};
+
+#endif /* SalesCache_hpp */
@@ -0,0 +1,191 @@
+//
+//  Schema.hpp
+//
+
+#ifndef Schema_hpp
+#define Schema_hpp
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <utility>
+
+#include "sqlite3.h"
+
+/**
+ * @brief A column of a SQL table, paired with the member variable of the Model subclass that holds its value.
+ *
+ * Created with Schema::column(). A Model subclass describes its table as a tuple of these, returned by a static constexpr schema()
+ * method, and uses the Schema functions to bind and read its member variables by column index.
+ */
+template<class M, class V>
+struct Column
+{
+    /** The name of the column in the SQL table. */
+    const char *name;
+
+    /** The member variable that holds the value of the column. */
+    V M::*member;
+};
+
+/**
+ * @brief Binds and reads the columns of a Model subclass, using the compile-time schema the subclass describes itself with.
+ *
+ * The type of each column is known at compile time, so binding and reading a column goes straight to the right sqlite3 function.
+ * Only bool, int, double, and std::string member variables are supported. Using any other type fails to compile.
+ *
+ * For example, a model of a table with columns (name TEXT, price REAL) would declare:
+ *     static constexpr auto schema()
+ *     {
+ *         return std::make_tuple(Schema::column("name", &MenuItem::name),
+ *                                Schema::column("price", &MenuItem::price));
+ *     }
+ */
+class Schema
+{
+public:
+    /**
+     * @brief Creates a column of a schema.
+     *
+     * @param name the name of the column in the SQL table
+     * @param member the member variable that holds the value of the column
+     * @return the column
+     */
+    template<class M, class V>
+    static constexpr Column<M, V> column(const char *name, V M::*member)
+    {
+        return Column<M, V> { name, member };
+    }
+
+    /**
+     * @brief Gets the names of the columns of a schema, in order.
+     *
+     * @param schema the schema, as returned by a model's schema() method
+     * @return vector of column names
+     */
+    template<class... Cs>
+    static std::vector<std::string> names(const std::tuple<Cs...> &schema)
+    {
+        return namesHelper(schema, std::index_sequence_for<Cs...>());
+    }
+
+    /**
+     * @brief Binds the value of a model's column to a statement parameter.
+     *
+     * @param model the model to get the value from
+     * @param schema the schema of the model
+     * @param column the index of the column in the schema
+     * @param statement the statement to bind
+     * @param index the sqlite3 statement parameter index
+     * @return the result of the sqlite3 bind function, SQLITE_RANGE if column is out of range
+     */
+    template<class M, class... Cs>
+    static int bind(const M &model, const std::tuple<Cs...> &schema, int column, sqlite3_stmt *statement, int index)
+    {
+        return bindHelper(model, schema, column, statement, index, std::index_sequence_for<Cs...>());
+    }
+
+    /**
+     * @brief Reads the value of a result column into a model's member variable.
+     *
+     * Does nothing if column is out of range.
+     *
+     * @param model the model to set the value of
+     * @param schema the schema of the model
+     * @param column the index of the column in the schema
+     * @param statement the statement that has a result row
+     * @param index the index of the result column
+     */
+    template<class M, class... Cs>
+    static void read(M &model, const std::tuple<Cs...> &schema, int column, sqlite3_stmt *statement, int index)
+    {
+        readHelper(model, schema, column, statement, index, std::index_sequence_for<Cs...>());
+    }
+
+    /**
+     * @brief Reads the value of a result column.
+     *
+     * Overloaded for bool, int, long long, double, and std::string. A NULL value is read as 0 or an empty string.
+     *
+     * @param statement the statement that has a result row
+     * @param index the index of the result column
+     * @param value set to the value of the result column
+     */
+    static void readValue(sqlite3_stmt *statement, int index, bool &value)
+    {
+        value = sqlite3_column_int(statement, index) != 0;
+    }
+
+    static void readValue(sqlite3_stmt *statement, int index, int &value)
+    {
+        value = sqlite3_column_int(statement, index);
+    }
+
+    static void readValue(sqlite3_stmt *statement, int index, long long &value)
+    {
+        value = sqlite3_column_int64(statement, index);
+    }
+
+    static void readValue(sqlite3_stmt *statement, int index, double &value)
+    {
+        value = sqlite3_column_double(statement, index);
+    }
+
+    static void readValue(sqlite3_stmt *statement, int index, std::string &value)
+    {
+        // Assigning in place reuses the string's buffer. A NULL value is read as an empty string.
+        const char *text = (const char *)sqlite3_column_text(statement, index);
+        if (text == NULL)
+        {
+            value.clear();
+            return;
+        }
+        value.assign(text, sqlite3_column_bytes(statement, index));
+    }
+
+private:
+    template<class Tuple, std::size_t... Is>
+    static std::vector<std::string> namesHelper(const Tuple &schema, std::index_sequence<Is...>)
+    {
+        return { std::get<Is>(schema).name... };
+    }
+
+    template<class M, class Tuple, std::size_t... Is>
+    static int bindHelper(const M &model, const Tuple &schema, int column, sqlite3_stmt *statement, int index, std::index_sequence<Is...>)
+    {
+        int result = SQLITE_RANGE;
+        // Only the element whose position matches column is bound.
+        (void)((column == (int)Is && (result = bindValue(statement, index, model.*(std::get<Is>(schema).member)), true)) || ...);
+        return result;
+    }
+
+    template<class M, class Tuple, std::size_t... Is>
+    static void readHelper(M &model, const Tuple &schema, int column, sqlite3_stmt *statement, int index, std::index_sequence<Is...>)
+    {
+        // Only the element whose position matches column is read.
+        (void)((column == (int)Is && (readValue(statement, index, model.*(std::get<Is>(schema).member)), true)) || ...);
+    }
+
+    static int bindValue(sqlite3_stmt *statement, int index, bool value)
+    {
+        return sqlite3_bind_int(statement, index, value);
+    }
+
+    static int bindValue(sqlite3_stmt *statement, int index, int value)
+    {
+        return sqlite3_bind_int(statement, index, value);
+    }
+
+    static int bindValue(sqlite3_stmt *statement, int index, double value)
+    {
+        return sqlite3_bind_double(statement, index, value);
+    }
+
+    static int bindValue(sqlite3_stmt *statement, int index, const std::string &value)
+    {
+        // Not copied, since the model is stepped and its bindings cleared before the DBHelper method that bound it returns.
+        return sqlite3_bind_text(statement, index, value.c_str(), (int)value.size(), SQLITE_STATIC);
+    }
+};
+
+#endif /* Schema_hpp */
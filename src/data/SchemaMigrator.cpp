@@ -0,0 +1,765 @@
+//
+//  SchemaMigrator.cpp
+//
+
+#include "SchemaMigrator.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+const std::vector<SchemaMigrator::Migration> & SchemaMigrator::getSchemaMigrations()
+{
+    static const std::vector<Migration> schemaMigrations = {
+        {
+            1, "Tables and views",
+            R"sql(
+CREATE TABLE IF NOT EXISTS OrderMaster (
+    orderNumber INTEGER NOT NULL PRIMARY KEY,
+    orderedBy TEXT NOT NULL,
+    orderDate TEXT NOT NULL,
+    status TEXT NOT NULL,
+    sessionID TEXT NOT NULL
+);
+
+CREATE INDEX IF NOT EXISTS OrderDate ON OrderMaster(orderDate);
+
+CREATE TABLE IF NOT EXISTS OrderDetail (
+    orderDetailID INTEGER NOT NULL PRIMARY KEY,
+    orderNumber INTEGER NOT NULL,
+    menuItemName TEXT NOT NULL,
+    quantity INTEGER NOT NULL
+);
+
+CREATE INDEX IF NOT EXISTS OrderDetailOrderNumber
+    ON OrderDetail(orderNumber);
+
+CREATE TABLE IF NOT EXISTS MenuItem (
+    name TEXT NOT NULL PRIMARY KEY,
+    price REAL NOT NULL,
+    description TEXT NOT NULL
+);
+
+CREATE UNIQUE INDEX IF NOT EXISTS MenuItemName ON MenuItem(name);
+
+CREATE VIEW IF NOT EXISTS vOrderDetail AS
+    SELECT od.orderDetailID,
+        od.orderNumber,
+        od.menuItemName,
+        od.quantity,
+        m.price,
+        (od.quantity * m.price) AS total
+    FROM OrderDetail AS od
+    LEFT OUTER JOIN MenuItem AS m ON m.name=od.menuItemName;
+
+CREATE VIEW IF NOT EXISTS vOrderSales AS
+    SELECT DATETIME(DATE(om.orderDate)) AS salesDate,
+        od.menuItemName,
+        SUM(od.quantity) AS totalQuantity,
+        SUM(od.quantity * m.price) AS totalRevenue,
+        0 AS isAllMenuItems
+    FROM OrderDetail AS od
+    INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+    INNER JOIN OrderMaster AS om ON om.orderNumber=od.orderNumber
+    GROUP BY salesDate,menuItemName
+    UNION
+        SELECT DATETIME(DATE(om2.orderDate)) AS salesDate,
+            'All menu items' AS menuItemName,
+            SUM(od2.quantity) AS totalQuantity,
+            SUM(od2.quantity * m2.price) AS totalRevenue,
+            1 AS isAllMenuItems
+        FROM OrderDetail AS od2
+        INNER JOIN MenuItem AS m2 ON m2.name=od2.menuItemName
+        INNER JOIN OrderMaster AS om2
+            ON om2.orderNumber=od2.orderNumber
+        GROUP BY salesDate;
+
+CREATE TABLE IF NOT EXISTS InventoryItem (
+    itemID INTEGER NOT NULL PRIMARY KEY,
+    itemName TEXT NOT NULL,
+    quantity INTEGER NOT NULL
+);
+
+CREATE TABLE IF NOT EXISTS MenuItemIngredient (
+    menuItemName TEXT NOT NULL,
+    inventoryItemID TEXT NOT NULL,
+    quantity INTEGER NOT NULL,
+    PRIMARY KEY (menuItemName,inventoryItemID)
+);
+
+CREATE TABLE IF NOT EXISTS Admin (
+    userName TEXT NOT NULL PRIMARY KEY,
+    password TEXT NOT NULL
+);
+)sql"
+        },
+        {
+            2, "DailySales rollup",
+            R"sql(
+-- Total quantity and revenue of each menu item for each day, counting every
+-- order that has been checked out (status is not 'cart').
+-- Kept current by the triggers below, so reading it does not re-aggregate
+-- every order line.
+CREATE TABLE IF NOT EXISTS DailySales (
+    salesDate TEXT NOT NULL,
+    menuItemName TEXT NOT NULL,
+    totalQuantity INTEGER NOT NULL,
+    totalRevenue REAL NOT NULL,
+    PRIMARY KEY (salesDate,menuItemName)
+) WITHOUT ROWID;
+
+-- Removes the row of a menu item for a day once all of its sales have been
+-- subtracted.
+CREATE TRIGGER IF NOT EXISTS DailySalesRemoveEmpty
+    AFTER UPDATE OF totalQuantity ON DailySales
+    WHEN NEW.totalQuantity = 0
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=NEW.salesDate AND menuItemName=NEW.menuItemName;
+END;
+
+-- Adds the lines of an order to DailySales when it is checked out.
+CREATE TRIGGER IF NOT EXISTS DailySalesOrderAdd
+    AFTER UPDATE OF status,orderDate ON OrderMaster
+    WHEN NEW.status != 'cart'
+        AND (OLD.status = 'cart' OR OLD.orderDate != NEW.orderDate)
+BEGIN
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(NEW.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderDetail AS od
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE od.orderNumber=NEW.orderNumber
+        GROUP BY od.menuItemName
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+END;
+
+-- Subtracts the lines of a checked out order from DailySales if it is moved
+-- back to the cart or to a different date.
+CREATE TRIGGER IF NOT EXISTS DailySalesOrderRemove
+    AFTER UPDATE OF status,orderDate ON OrderMaster
+    WHEN OLD.status != 'cart'
+        AND (NEW.status = 'cart' OR OLD.orderDate != NEW.orderDate)
+BEGIN
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(OLD.orderDate)),
+            od.menuItemName,
+            -SUM(od.quantity),
+            -SUM(od.quantity * m.price)
+        FROM OrderDetail AS od
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE od.orderNumber=OLD.orderNumber
+        GROUP BY od.menuItemName
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesOrderDelete
+    AFTER DELETE ON OrderMaster
+    WHEN OLD.status != 'cart'
+BEGIN
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(OLD.orderDate)),
+            od.menuItemName,
+            -SUM(od.quantity),
+            -SUM(od.quantity * m.price)
+        FROM OrderDetail AS od
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE od.orderNumber=OLD.orderNumber
+        GROUP BY od.menuItemName
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+END;
+
+-- Order lines added to, removed from, or changed in a checked out order.
+CREATE TRIGGER IF NOT EXISTS DailySalesDetailInsert
+    AFTER INSERT ON OrderDetail
+BEGIN
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(om.orderDate)),
+            NEW.menuItemName,
+            NEW.quantity,
+            NEW.quantity * m.price
+        FROM OrderMaster AS om
+        INNER JOIN MenuItem AS m ON m.name=NEW.menuItemName
+        WHERE om.orderNumber=NEW.orderNumber AND om.status != 'cart'
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesDetailDelete
+    AFTER DELETE ON OrderDetail
+BEGIN
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(om.orderDate)),
+            OLD.menuItemName,
+            -OLD.quantity,
+            -OLD.quantity * m.price
+        FROM OrderMaster AS om
+        INNER JOIN MenuItem AS m ON m.name=OLD.menuItemName
+        WHERE om.orderNumber=OLD.orderNumber AND om.status != 'cart'
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesDetailUpdate
+    AFTER UPDATE OF orderNumber,menuItemName,quantity ON OrderDetail
+BEGIN
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(om.orderDate)),
+            OLD.menuItemName,
+            -OLD.quantity,
+            -OLD.quantity * m.price
+        FROM OrderMaster AS om
+        INNER JOIN MenuItem AS m ON m.name=OLD.menuItemName
+        WHERE om.orderNumber=OLD.orderNumber AND om.status != 'cart'
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(om.orderDate)),
+            NEW.menuItemName,
+            NEW.quantity,
+            NEW.quantity * m.price
+        FROM OrderMaster AS om
+        INNER JOIN MenuItem AS m ON m.name=NEW.menuItemName
+        WHERE om.orderNumber=NEW.orderNumber AND om.status != 'cart'
+        ON CONFLICT (salesDate,menuItemName) DO UPDATE
+            SET totalQuantity=totalQuantity+excluded.totalQuantity,
+                totalRevenue=totalRevenue+excluded.totalRevenue;
+END;
+
+-- Fills DailySales from the orders that were placed before the triggers existed.
+-- A database created by the old sql/tables.sql already has the table, which is emptied first, so both are filled the same way
+-- and a duplicate key fails the migration instead of being skipped.
+DELETE FROM DailySales;
+
+INSERT INTO DailySales
+    SELECT DATETIME(DATE(om.orderDate)) AS salesDate,
+        od.menuItemName,
+        SUM(od.quantity),
+        SUM(od.quantity * m.price)
+    FROM OrderDetail AS od
+    INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+    INNER JOIN OrderMaster AS om ON om.orderNumber=od.orderNumber
+    WHERE om.status != 'cart'
+    GROUP BY salesDate,od.menuItemName;
+
+DROP VIEW IF EXISTS vOrderSales;
+
+CREATE VIEW vOrderSales AS
+    SELECT salesDate,
+        menuItemName,
+        totalQuantity,
+        totalRevenue,
+        0 AS isAllMenuItems
+    FROM DailySales
+    UNION ALL
+        SELECT salesDate,
+            'All menu items' AS menuItemName,
+            SUM(totalQuantity) AS totalQuantity,
+            SUM(totalRevenue) AS totalRevenue,
+            1 AS isAllMenuItems
+        FROM DailySales
+        GROUP BY salesDate;
+)sql"
+        },
+        {
+            3, "Cart detail view",
+            R"sql(
+-- The lines of each order with their prices, and the session and status of
+-- the order, so that a session's cart can be read with one query.
+CREATE VIEW IF NOT EXISTS vCartDetail AS
+    SELECT od.orderDetailID,
+        od.orderNumber,
+        od.menuItemName,
+        od.quantity,
+        IFNULL(m.price, 0) AS price,
+        IFNULL(od.quantity * m.price, 0) AS total,
+        om.sessionID,
+        om.status
+    FROM OrderMaster AS om
+    INNER JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+    LEFT OUTER JOIN MenuItem AS m ON m.name=od.menuItemName;
+)sql"
+        },
+        {
+            4, "Indexes for the hot queries",
+            R"sql(
+-- A session's cart: WHERE sessionID=? AND status='cart'.
+CREATE INDEX IF NOT EXISTS OrderMasterSessionStatus
+    ON OrderMaster(sessionID, status);
+
+-- The open orders: counted by status, and paged by status in order of
+-- (orderDate, orderNumber). orderNumber is the rowid, so it is part of
+-- every index entry and the pages are read in index order without sorting.
+CREATE INDEX IF NOT EXISTS OrderMasterStatusOrderDate
+    ON OrderMaster(status, orderDate);
+
+-- The lines of an order, sorted by menu item, and the line of one menu item
+-- in an order. Replaces the index on orderNumber alone, which it covers.
+DROP INDEX IF EXISTS OrderDetailOrderNumber;
+
+CREATE INDEX IF NOT EXISTS OrderDetailOrderNumberMenuItem
+    ON OrderDetail(orderNumber, menuItemName);
+
+-- The menu items that use an inventory item. The primary key only covers
+-- lookups by menuItemName.
+CREATE INDEX IF NOT EXISTS MenuItemIngredientInventoryItem
+    ON MenuItemIngredient(inventoryItemID);
+)sql"
+        },
+        {
+            5, "DailySales recomputed from the orders",
+            R"sql(
+-- The triggers of migration 2 added and subtracted each change at the
+-- current menu price, so removing a line after a price change, or after its
+-- menu item was removed, left DailySales wrong for good. Instead, each
+-- trigger below recomputes the rows of DailySales that the change affects,
+-- the same way migration 2 filled the table, so DailySales always holds what
+-- that query would return.
+-- The orders of a day are found by the OrderDate index, with
+-- orderDate >= DATE(x) AND orderDate < DATE(x,'+1 day') in place of
+-- DATE(orderDate)=DATE(x), which cannot use it. CROSS JOIN keeps SQLite from
+-- reading every line of the menu item first instead.
+DROP TRIGGER IF EXISTS DailySalesRemoveEmpty;
+DROP TRIGGER IF EXISTS DailySalesOrderAdd;
+DROP TRIGGER IF EXISTS DailySalesOrderRemove;
+DROP TRIGGER IF EXISTS DailySalesOrderDelete;
+DROP TRIGGER IF EXISTS DailySalesDetailInsert;
+DROP TRIGGER IF EXISTS DailySalesDetailDelete;
+DROP TRIGGER IF EXISTS DailySalesDetailUpdate;
+
+-- The menu items of an order on the day it is checked out to, or moved to.
+CREATE TRIGGER IF NOT EXISTS DailySalesOrderAdd
+    AFTER UPDATE OF status,orderDate ON OrderMaster
+    WHEN NEW.status != 'cart'
+        AND (OLD.status = 'cart' OR OLD.orderDate != NEW.orderDate)
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=DATETIME(DATE(NEW.orderDate))
+            AND menuItemName IN (SELECT menuItemName FROM OrderDetail
+                                 WHERE orderNumber=NEW.orderNumber);
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(NEW.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS om
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE om.orderDate >= DATE(NEW.orderDate)
+            AND om.orderDate < DATE(NEW.orderDate, '+1 day')
+            AND om.status != 'cart'
+            AND od.menuItemName IN (SELECT menuItemName FROM OrderDetail
+                                    WHERE orderNumber=NEW.orderNumber)
+        GROUP BY od.menuItemName;
+END;
+
+-- The menu items of a checked out order on the day it is moved from, or on
+-- which it was placed if it is moved back to the cart or deleted.
+CREATE TRIGGER IF NOT EXISTS DailySalesOrderRemove
+    AFTER UPDATE OF status,orderDate ON OrderMaster
+    WHEN OLD.status != 'cart'
+        AND (NEW.status = 'cart' OR OLD.orderDate != NEW.orderDate)
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=DATETIME(DATE(OLD.orderDate))
+            AND menuItemName IN (SELECT menuItemName FROM OrderDetail
+                                 WHERE orderNumber=OLD.orderNumber);
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(OLD.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS om
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE om.orderDate >= DATE(OLD.orderDate)
+            AND om.orderDate < DATE(OLD.orderDate, '+1 day')
+            AND om.status != 'cart'
+            AND od.menuItemName IN (SELECT menuItemName FROM OrderDetail
+                                    WHERE orderNumber=OLD.orderNumber)
+        GROUP BY od.menuItemName;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesOrderDelete
+    AFTER DELETE ON OrderMaster
+    WHEN OLD.status != 'cart'
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=DATETIME(DATE(OLD.orderDate))
+            AND menuItemName IN (SELECT menuItemName FROM OrderDetail
+                                 WHERE orderNumber=OLD.orderNumber);
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(OLD.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS om
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE om.orderDate >= DATE(OLD.orderDate)
+            AND om.orderDate < DATE(OLD.orderDate, '+1 day')
+            AND om.status != 'cart'
+            AND od.menuItemName IN (SELECT menuItemName FROM OrderDetail
+                                    WHERE orderNumber=OLD.orderNumber)
+        GROUP BY od.menuItemName;
+END;
+
+-- The menu item of an order line added to, removed from, or changed in a
+-- checked out order, on the day of that order. Nothing is recomputed for the
+-- lines of a cart, since the join with its order finds no day.
+CREATE TRIGGER IF NOT EXISTS DailySalesDetailInsert
+    AFTER INSERT ON OrderDetail
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=(SELECT DATETIME(DATE(orderDate)) FROM OrderMaster
+                         WHERE orderNumber=NEW.orderNumber AND status != 'cart')
+            AND menuItemName=NEW.menuItemName;
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(o.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS o
+        CROSS JOIN OrderMaster AS om
+            ON om.orderDate >= DATE(o.orderDate)
+            AND om.orderDate < DATE(o.orderDate, '+1 day')
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE o.orderNumber=NEW.orderNumber AND o.status != 'cart'
+            AND om.status != 'cart'
+            AND od.menuItemName=NEW.menuItemName
+        GROUP BY od.menuItemName;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesDetailDelete
+    AFTER DELETE ON OrderDetail
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=(SELECT DATETIME(DATE(orderDate)) FROM OrderMaster
+                         WHERE orderNumber=OLD.orderNumber AND status != 'cart')
+            AND menuItemName=OLD.menuItemName;
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(o.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS o
+        CROSS JOIN OrderMaster AS om
+            ON om.orderDate >= DATE(o.orderDate)
+            AND om.orderDate < DATE(o.orderDate, '+1 day')
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE o.orderNumber=OLD.orderNumber AND o.status != 'cart'
+            AND om.status != 'cart'
+            AND od.menuItemName=OLD.menuItemName
+        GROUP BY od.menuItemName;
+END;
+
+-- DBHelper::update() sets every column, so a line whose columns did not
+-- change is skipped.
+CREATE TRIGGER IF NOT EXISTS DailySalesDetailUpdate
+    AFTER UPDATE OF orderNumber,menuItemName,quantity ON OrderDetail
+    WHEN OLD.orderNumber != NEW.orderNumber
+        OR OLD.menuItemName != NEW.menuItemName
+        OR OLD.quantity != NEW.quantity
+BEGIN
+    DELETE FROM DailySales
+        WHERE salesDate=(SELECT DATETIME(DATE(orderDate)) FROM OrderMaster
+                         WHERE orderNumber=OLD.orderNumber AND status != 'cart')
+            AND menuItemName=OLD.menuItemName;
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(o.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS o
+        CROSS JOIN OrderMaster AS om
+            ON om.orderDate >= DATE(o.orderDate)
+            AND om.orderDate < DATE(o.orderDate, '+1 day')
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE o.orderNumber=OLD.orderNumber AND o.status != 'cart'
+            AND om.status != 'cart'
+            AND od.menuItemName=OLD.menuItemName
+        GROUP BY od.menuItemName;
+    DELETE FROM DailySales
+        WHERE salesDate=(SELECT DATETIME(DATE(orderDate)) FROM OrderMaster
+                         WHERE orderNumber=NEW.orderNumber AND status != 'cart')
+            AND menuItemName=NEW.menuItemName;
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(o.orderDate)),
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderMaster AS o
+        CROSS JOIN OrderMaster AS om
+            ON om.orderDate >= DATE(o.orderDate)
+            AND om.orderDate < DATE(o.orderDate, '+1 day')
+        CROSS JOIN OrderDetail AS od ON od.orderNumber=om.orderNumber
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        WHERE o.orderNumber=NEW.orderNumber AND o.status != 'cart'
+            AND om.status != 'cart'
+            AND od.menuItemName=NEW.menuItemName
+        GROUP BY od.menuItemName;
+END;
+
+-- Every day of a menu item whose price changes, or which is added to or
+-- removed from the menu. Revenue is counted at the current price, as it was
+-- by the old vOrderSales view. These read all the order lines, but the menu
+-- is rarely changed.
+CREATE TRIGGER IF NOT EXISTS DailySalesMenuItemInsert
+    AFTER INSERT ON MenuItem
+BEGIN
+    DELETE FROM DailySales WHERE menuItemName=NEW.name;
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(om.orderDate)) AS salesDate,
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderDetail AS od
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        INNER JOIN OrderMaster AS om ON om.orderNumber=od.orderNumber
+        WHERE od.menuItemName=NEW.name AND om.status != 'cart'
+        GROUP BY salesDate,od.menuItemName;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesMenuItemUpdate
+    AFTER UPDATE OF name,price ON MenuItem
+    WHEN OLD.name != NEW.name OR OLD.price != NEW.price
+BEGIN
+    DELETE FROM DailySales WHERE menuItemName IN (OLD.name, NEW.name);
+    INSERT INTO DailySales
+        SELECT DATETIME(DATE(om.orderDate)) AS salesDate,
+            od.menuItemName,
+            SUM(od.quantity),
+            SUM(od.quantity * m.price)
+        FROM OrderDetail AS od
+        INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+        INNER JOIN OrderMaster AS om ON om.orderNumber=od.orderNumber
+        WHERE od.menuItemName IN (OLD.name, NEW.name) AND om.status != 'cart'
+        GROUP BY salesDate,od.menuItemName;
+END;
+
+CREATE TRIGGER IF NOT EXISTS DailySalesMenuItemDelete
+    AFTER DELETE ON MenuItem
+BEGIN
+    DELETE FROM DailySales WHERE menuItemName=OLD.name;
+END;
+
+-- Recomputes the whole table, in case it drifted under the old triggers.
+DELETE FROM DailySales;
+
+INSERT INTO DailySales
+    SELECT DATETIME(DATE(om.orderDate)) AS salesDate,
+        od.menuItemName,
+        SUM(od.quantity),
+        SUM(od.quantity * m.price)
+    FROM OrderDetail AS od
+    INNER JOIN MenuItem AS m ON m.name=od.menuItemName
+    INNER JOIN OrderMaster AS om ON om.orderNumber=od.orderNumber
+    WHERE om.status != 'cart'
+    GROUP BY salesDate,od.menuItemName;
+)sql"
+        }
+    };
+    return schemaMigrations;
+}
+
+namespace
+{
+    /**
+     * @brief The state of the progress handler while a statement runs.
+     */
+    struct ProgressState
+    {
+        /** The progress reported to the listener. */
+        SchemaMigrator::Progress progress;
+
+        /** Called with the progress. */
+        const SchemaMigrator::ProgressListener *listener;
+
+        /** When the statement started. */
+        std::chrono::steady_clock::time_point start;
+
+        /** When the progress was last reported. */
+        std::chrono::steady_clock::time_point lastReport;
+    };
+
+    /**
+     * @brief Called by SQLite3 every few thousand instructions of a statement, so that long statements report their progress.
+     *
+     * @param data the ProgressState of the statement
+     * @return 0, to let the statement continue
+     */
+    int onProgress(void *data)
+    {
+        ProgressState *state = static_cast<ProgressState *>(data);
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - state->lastReport >= std::chrono::seconds(1))
+        {
+            state->lastReport = now;
+            state->progress.elapsedMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now - state->start).count();
+            (*state->listener)(state->progress);
+        }
+        return 0;
+    }
+}
+
+SchemaMigrator::SchemaMigrator(const std::vector<Migration> &migrations)
+{
+    for (int i = 0; i < migrations.size(); i++)
+    {
+        if (migrations[i].version != i + 1)
+        {
+            throw std::runtime_error("Error in call to SchemaMigrator::SchemaMigrator(). Migration " + std::to_string(i + 1) +
+                                     " has version " + std::to_string(migrations[i].version) + ".");
+        }
+    }
+    this->migrations = migrations;
+}
+
+int SchemaMigrator::getLatestVersion() const
+{
+    return (int)migrations.size();
+}
+
+int SchemaMigrator::getVersion(sqlite3 *db)
+{
+    sqlite3_stmt *statement = NULL;
+    int result = sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &statement, NULL);
+    if (result == SQLITE_OK)
+    {
+        result = sqlite3_step(statement);
+    }
+    if (result != SQLITE_ROW)
+    {
+        std::string sqliteMessage = sqlite3_errmsg(db);
+        sqlite3_finalize(statement);
+        throw std::runtime_error("Error in call to SchemaMigrator::getVersion(). SQLite3 error " + std::to_string(result) + ": " +
+                                 sqliteMessage);
+    }
+    int version = sqlite3_column_int(statement, 0);
+    sqlite3_finalize(statement);
+    return version;
+}
+
+int SchemaMigrator::migrate(sqlite3 *db, const ProgressListener &listener) const
+{
+    int version = getVersion(db);
+    if (version > getLatestVersion())
+    {
+        throw std::runtime_error("Error in call to SchemaMigrator::migrate(). The database is at schema version " +
+                                 std::to_string(version) + ", which is newer than this program's version " +
+                                 std::to_string(getLatestVersion()) + ".");
+    }
+
+    int numApplied = 0;
+    for (std::vector<Migration>::const_iterator it = migrations.begin() + version; it != migrations.end(); it++)
+    {
+        if (apply(db, *it, listener))
+        {
+            numApplied++;
+        }
+    }
+    return numApplied;
+}
+
+void SchemaMigrator::printProgress(const Progress &progress)
+{
+    // Statements that finish within a second are not reported, so a new database only prints one line per migration.
+    if (progress.elapsedMilliseconds == 0 && progress.statement > 1)
+    {
+        return;
+    }
+    std::cout << "Upgrading database to schema version " << progress.version << " (" << progress.description << ")";
+    if (progress.elapsedMilliseconds > 0)
+    {
+        std::cout << ": statement " << progress.statement << " of " << progress.numStatements;
+        std::cout << " running for " << progress.elapsedMilliseconds / 1000 << "s";
+    }
+    std::cout << std::endl;
+}
+
+bool SchemaMigrator::apply(sqlite3 *db, const Migration &migration, const ProgressListener &listener) const
+{
+    std::vector<std::string> statements = splitStatements(migration.sql);
+
+    // Waits for other writers, so that two processes opening the same database do not both apply the migration.
+    exec(db, "BEGIN IMMEDIATE;");
+    try
+    {
+        if (getVersion(db) >= migration.version)
+        {
+            exec(db, "COMMIT;");
+            return false;
+        }
+
+        ProgressState state;
+        state.progress.version = migration.version;
+        state.progress.description = migration.description;
+        state.progress.numStatements = (int)statements.size();
+        state.listener = &listener;
+        sqlite3_progress_handler(db, 10000, onProgress, &state);
+
+        for (int i = 0; i < statements.size(); i++)
+        {
+            state.progress.statement = i + 1;
+            state.progress.elapsedMilliseconds = 0;
+            state.start = std::chrono::steady_clock::now();
+            state.lastReport = state.start;
+            listener(state.progress);
+            exec(db, statements[i]);
+        }
+
+        sqlite3_progress_handler(db, 0, NULL, NULL);
+        exec(db, "PRAGMA user_version = " + std::to_string(migration.version) + ";");
+        exec(db, "COMMIT;");
+    }
+    catch (const std::exception &e)
+    {
+        sqlite3_progress_handler(db, 0, NULL, NULL);
+        sqlite3_exec(db, "ROLLBACK;", NULL, NULL, NULL);
+        throw std::runtime_error("Error in call to SchemaMigrator::migrate(). Migration to schema version " +
+                                 std::to_string(migration.version) + " (" + migration.description + ") was rolled back. " + e.what());
+    }
+    return true;
+}
+
+std::vector<std::string> SchemaMigrator::splitStatements(const std::string &sql)
+{
+    std::vector<std::string> statements;
+    std::string::size_type start = 0;
+    for (std::string::size_type end = sql.find(';'); end != std::string::npos; end = sql.find(';', end + 1))
+    {
+        std::string statement = sql.substr(start, end + 1 - start);
+        if (sqlite3_complete(statement.c_str()))
+        {
+            statements.push_back(statement);
+            start = end + 1;
+        }
+    }
+    return statements;
+}
+
+void SchemaMigrator::exec(sqlite3 *db, const std::string &sql)
+{
+    char *errorMessage = NULL;
+    int result = sqlite3_exec(db, sql.c_str(), NULL, NULL, &errorMessage);
+    if (result != SQLITE_OK)
+    {
+        std::string sqliteMessage = errorMessage != NULL ? errorMessage : sqlite3_errstr(result);
+        sqlite3_free(errorMessage);
+        throw std::runtime_error("SQLite3 error " + std::to_string(result) + ": " + sqliteMessage);
+    }
+}
@@ -0,0 +1,166 @@
+//
+//  SchemaMigrator.hpp
+//
+
+#ifndef SchemaMigrator_hpp
+#define SchemaMigrator_hpp
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+
+/**
+ * @brief Creates the database schema and upgrades it to the version this program was built with.
+ *
+ * The schema is built by an ordered list of migrations, each numbered with the schema version it upgrades the database to.
+ * The version of a database is kept in PRAGMA user_version, which is 0 for a new database. migrate() applies every migration
+ * newer than that version, each in its own transaction together with the new user_version, so a migration that fails leaves the
+ * database at the previous version.
+ *
+ * To change the schema, add a migration to the end of the list in SchemaMigrator.cpp. Migrations that have been released must
+ * not be edited, since databases that already applied them will not apply them again.
+ *
+ * Migrations 1 to 4 recreate the schema of the old sql/tables.sql, using IF NOT EXISTS, so that databases created from it,
+ * which are at version 0, are upgraded without losing their data.
+ */
+class SchemaMigrator
+{
+public:
+    /**
+     * @brief One step of the schema history.
+     */
+    struct Migration
+    {
+        /** The schema version the database is at after this migration. */
+        int version;
+
+        /** Describes the change, shown in progress reports. */
+        std::string description;
+
+        /** The SQL statements, separated by semicolons. */
+        std::string sql;
+    };
+
+    /**
+     * @brief How far a migration has got, reported before each statement and about once a second while a long statement runs.
+     */
+    struct Progress
+    {
+        /** The version of the migration being applied. */
+        int version;
+
+        /** The description of the migration being applied. */
+        std::string description;
+
+        /** The number of the statement being run, starting at 1. */
+        int statement;
+
+        /** The number of statements in the migration. */
+        int numStatements;
+
+        /** Milliseconds since the statement started. */
+        long long elapsedMilliseconds;
+    };
+
+    /**
+     * @brief Called with the progress of migrate().
+     */
+    typedef std::function<void(const Progress &)> ProgressListener;
+
+    /**
+     * @brief Gets the migrations of this program's schema, in order.
+     *
+     * @return the migrations
+     */
+    static const std::vector<Migration> & getSchemaMigrations();
+
+    /**
+     * @brief Constructor.
+     *
+     * Throws a runtime exception if the versions of the migrations are not 1, 2, 3, and so on.
+     *
+     * @param migrations the migrations to apply, in order
+     */
+    SchemaMigrator(const std::vector<Migration> &migrations = getSchemaMigrations());
+
+    /**
+     * @brief Gets the version of the last migration.
+     *
+     * @return the latest schema version
+     */
+    int getLatestVersion() const;
+
+    /**
+     * @brief Gets the schema version of a database.
+     *
+     * Throws a runtime exception if it cannot be read.
+     *
+     * @param db the database handle
+     * @return the value of PRAGMA user_version
+     */
+    static int getVersion(sqlite3 *db);
+
+    /**
+     * @brief Applies the migrations newer than the database's version, in order.
+     *
+     * Each migration runs in an immediate transaction, so other connections and processes wait for it, and the version is read
+     * again inside it, so a migration that another process has already applied is skipped.
+     *
+     * Throws a runtime exception if a migration fails, after rolling it back, or if the database is newer than the latest version.
+     *
+     * @param db the database handle, which must not be in a transaction
+     * @param listener called with the progress of each migration
+     * @return the number of migrations applied
+     */
+    int migrate(sqlite3 *db, const ProgressListener &listener = printProgress) const;
+
+    /**
+     * @brief Prints a progress report to the standard output.
+     *
+     * Prints the start of each migration, and each statement that has been running for over a second.
+     *
+     * @param progress the progress of the current migration
+     */
+    static void printProgress(const Progress &progress);
+
+private:
+    /**
+     * @brief The migrations, in order of version.
+     */
+    std::vector<Migration> migrations;
+
+    /**
+     * @brief Applies one migration and sets user_version to its version, in one transaction.
+     *
+     * @param db the database handle
+     * @param migration the migration
+     * @param listener called with the progress of the migration
+     * @return false if the database was already at or past the migration's version
+     */
+    bool apply(sqlite3 *db, const Migration &migration, const ProgressListener &listener) const;
+
+    /**
+     * @brief Splits SQL into its statements.
+     *
+     * A semicolon only ends a statement if the text before it is a complete statement, so the semicolons in triggers, string
+     * literals, and comments are kept.
+     *
+     * @param sql the SQL statements, separated by semicolons
+     * @return the statements, each ending with its semicolon
+     */
+    static std::vector<std::string> splitStatements(const std::string &sql);
+
+    /**
+     * @brief Runs a statement that returns no rows.
+     *
+     * Throws a runtime exception if it fails.
+     *
+     * @param db the database handle
+     * @param sql the statement
+     */
+    static void exec(sqlite3 *db, const std::string &sql);
+};
+
+#endif /* SchemaMigrator_hpp */
@@ -0,0 +1,340 @@
+//
+//  SmallVector.hpp
+//
+
+#ifndef SmallVector_hpp
+#define SmallVector_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A vector that keeps up to N elements inside the object, and only allocates once it grows past them.
+ *
+ * Used for short lists such as the values of an IN condition, which usually have a few elements. Only supports adding elements,
+ * since that is all those lists need.
+ *
+ * The elements are either all inside the object or, once there are more than N, all in a std::vector.
+ */
+template<class T, std::size_t N>
+class SmallVector
+{
+public:
+    /**
+     * @brief Constructor creates an empty SmallVector.
+     */
+    SmallVector() : count(0), spilled(false)
+    {
+    }
+
+    /**
+     * @brief Constructor creates a SmallVector holding copies of the given values.
+     *
+     * @param values the values
+     */
+    SmallVector(std::initializer_list<T> values) : count(0), spilled(false)
+    {
+        reserve(values.size());
+        for (const T &value : values)
+        {
+            push_back(value);
+        }
+    }
+
+    /**
+     * @brief Constructor creates a SmallVector holding the values of a std::vector, which are moved.
+     *
+     * @param values the values
+     */
+    explicit SmallVector(std::vector<T> &&values) : count(0), spilled(false)
+    {
+        if (values.size() > N)
+        {
+            heap = std::move(values);
+            count = heap.size();
+            spilled = true;
+            return;
+        }
+        for (T &value : values)
+        {
+            push_back(std::move(value));
+        }
+    }
+
+    /**
+     * @brief Copy constructor.
+     *
+     * @param other the SmallVector to copy
+     */
+    SmallVector(const SmallVector &other) : count(0), spilled(false)
+    {
+        reserve(other.count);
+        for (const T &value : other)
+        {
+            push_back(value);
+        }
+    }
+
+    /**
+     * @brief Move constructor.
+     *
+     * Does not allocate, since the elements are either moved inside the object or the heap vector is taken over. Requires T to
+     * be nothrow move constructible, as the values of a SqlCondition are.
+     *
+     * @param other the SmallVector to move from, left empty
+     */
+    SmallVector(SmallVector &&other) noexcept : count(0), spilled(false)
+    {
+        moveFrom(other);
+    }
+
+    /**
+     * @brief Copy assignment operator overload.
+     *
+     * @param other the SmallVector to copy
+     * @return this SmallVector
+     */
+    SmallVector & operator=(const SmallVector &other)
+    {
+        if (this != &other)
+        {
+            SmallVector copy(other);
+            clear();
+            moveFrom(copy);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator overload.
+     *
+     * @param other the SmallVector to move from, left empty
+     * @return this SmallVector
+     */
+    SmallVector & operator=(SmallVector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~SmallVector()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Adds an element to the end.
+     *
+     * @param value the element
+     */
+    void push_back(T value)
+    {
+        if (!spilled && count < N)
+        {
+            new (inlineData() + count) T(std::move(value));
+        }
+        else
+        {
+            if (!spilled)
+            {
+                spill();
+            }
+            heap.push_back(std::move(value));
+        }
+        count++;
+    }
+
+    /**
+     * @brief Makes room for a number of elements, so that adding them allocates at most once.
+     *
+     * @param capacity the number of elements
+     */
+    void reserve(std::size_t capacity)
+    {
+        // The elements stay inside the object until they spill, which then does not allocate again.
+        if (capacity > N)
+        {
+            heap.reserve(capacity);
+        }
+    }
+
+    /**
+     * @brief Removes all elements. Memory that was allocated is freed.
+     */
+    void clear()
+    {
+        if (!spilled)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                inlineData()[i].~T();
+            }
+        }
+        heap = std::vector<T>();
+        count = 0;
+        spilled = false;
+    }
+
+    /**
+     * @brief Gets the number of elements.
+     *
+     * @return the number of elements
+     */
+    std::size_t size() const
+    {
+        return count;
+    }
+
+    /**
+     * @brief Checks if there are no elements.
+     *
+     * @return true if there are no elements
+     */
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    /**
+     * @brief Gets the elements, which are contiguous.
+     *
+     * @return pointer to the first element
+     */
+    T * data()
+    {
+        return spilled ? heap.data() : inlineData();
+    }
+
+    const T * data() const
+    {
+        return spilled ? heap.data() : inlineData();
+    }
+
+    /**
+     * @brief Subscript operator overload.
+     *
+     * @param i the index of the element, which must be less than size()
+     * @return the element
+     */
+    T & operator[](std::size_t i)
+    {
+        return data()[i];
+    }
+
+    const T & operator[](std::size_t i) const
+    {
+        return data()[i];
+    }
+
+    /**
+     * @brief Gets an iterator to the first element.
+     *
+     * @return pointer to the first element
+     */
+    T * begin()
+    {
+        return data();
+    }
+
+    const T * begin() const
+    {
+        return data();
+    }
+
+    /**
+     * @brief Gets an iterator past the last element.
+     *
+     * @return pointer past the last element
+     */
+    T * end()
+    {
+        return data() + count;
+    }
+
+    const T * end() const
+    {
+        return data() + count;
+    }
+
+private:
+    /**
+     * @brief The number of elements.
+     */
+    std::size_t count;
+
+    /**
+     * @brief True once the elements have been moved to heap.
+     */
+    bool spilled;
+
+    /**
+     * @brief Storage for the first N elements. Only constructed up to count, until the elements spill.
+     */
+    alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+
+    /**
+     * @brief The elements, once there are more than N.
+     *
+     * Until the elements spill, it is empty, but may have been reserved by reserve().
+     */
+    std::vector<T> heap;
+
+    T * inlineData()
+    {
+        return reinterpret_cast<T *>(inlineBuffer);
+    }
+
+    const T * inlineData() const
+    {
+        return reinterpret_cast<const T *>(inlineBuffer);
+    }
+
+    /**
+     * @brief Moves the inline elements to heap, making room for twice as many.
+     */
+    void spill()
+    {
+        heap.reserve(std::max(heap.capacity(), 2 * N));
+        for (std::size_t i = 0; i < count; i++)
+        {
+            heap.push_back(std::move(inlineData()[i]));
+            inlineData()[i].~T();
+        }
+        spilled = true;
+    }
+
+    /**
+     * @brief Takes the elements of other, which is left empty. Must only be called while this SmallVector is empty.
+     *
+     * @param other the SmallVector to move from
+     */
+    void moveFrom(SmallVector &other)
+    {
+        if (other.spilled)
+        {
+            heap = std::move(other.heap);
+            count = other.count;
+            spilled = true;
+            other.clear();
+            return;
+        }
+        for (std::size_t i = 0; i < other.count; i++)
+        {
+            push_back(std::move(other.inlineData()[i]));
+        }
+        other.clear();
+    }
+};
+
+#endif /* SmallVector_hpp */
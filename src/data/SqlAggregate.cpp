@@ -0,0 +1,50 @@
+//
+//  SqlAggregate.cpp
+//
+
+#include "SqlAggregate.hpp"
+
+SqlAggregate::SqlAggregate(std::string function, std::string column)
+{
+    if (!isValidFunction(function))
+    {
+        throw std::runtime_error("Error in SqlAggregate constructor. '" + function + "' is not a valid aggregate function.");
+    }
+    if (column == "*" && function != "COUNT")
+    {
+        throw std::runtime_error("Error in SqlAggregate constructor. Only COUNT can be applied to '*'.");
+    }
+    
+    this->function = function;
+    this->column = column;
+}
+
+SqlAggregate::SqlAggregate(std::string column)
+{
+    this->column = column;
+}
+
+SqlAggregate::~SqlAggregate()
+{
+    
+}
+
+bool SqlAggregate::isValidFunction(std::string &function)
+{
+    std::string functionUpper;
+    for (std::string::iterator it = function.begin(); it != function.end(); it++)
+    {
+        functionUpper.push_back(std::toupper(*it));
+    }
+    function = functionUpper;
+    return function == "COUNT" || function == "SUM" || function == "MIN" || function == "MAX" || function == "AVG";
+}
+
+std::string SqlAggregate::toSql() const
+{
+    if (function.empty())
+    {
+        return column;
+    }
+    return function + "(" + column + ")";
+}
@@ -0,0 +1,75 @@
+//
+//  SqlAggregate.hpp
+//
+
+#ifndef SqlAggregate_hpp
+#define SqlAggregate_hpp
+
+#include <string>
+#include <stdexcept>
+
+/**
+ * @brief Class representing a result column of an aggregate query, used by DBHelper::aggregate().
+ *
+ * Either an aggregate function applied to a column:
+ *     SUM(quantity)
+ *     COUNT(*)
+ * or a plain column, which should be one of the columns the query is grouped by.
+ */
+class SqlAggregate
+{
+    friend class DBHelper;
+public:
+    /**
+     * @brief Constructor creates a SqlAggregate object that applies function to column.
+     *
+     * Throws a runtime exception if function is not one of the valid functions, or if column is "*" and function is not COUNT.
+     *
+     * @param function The aggregate function, one of COUNT, SUM, MIN, MAX, or AVG. Not case sensitive.
+     * @param column The column name, or "*" to count rows.
+     */
+    SqlAggregate(std::string function, std::string column);
+    
+    /**
+     * @brief Constructor creates a SqlAggregate object that selects a column as is.
+     *
+     * @param column The column name. Should be one of the columns the query is grouped by.
+     */
+    SqlAggregate(std::string column);
+    
+    /**
+     * @brief Destructor.
+     *
+     * Does nothing.
+     */
+    ~SqlAggregate();
+private:
+    /**
+     * @brief The aggregate function in uppercase, or empty if the column is selected as is.
+     */
+    std::string function;
+    
+    /**
+     * @brief The name of the column in the SQL table, or "*".
+     */
+    std::string column;
+    
+    /**
+     * @brief Changes function to uppercase, then returns true if it is a valid aggregate function.
+     *
+     * Valid functions: COUNT, SUM, MIN, MAX, AVG
+     *
+     * @param function The function.
+     * @return True if function is valid, false otherwise.
+     */
+    bool isValidFunction(std::string &function);
+    
+    /**
+     * @brief Generates the expression selecting this result column, e.g. "SUM(quantity)".
+     *
+     * @return the expression
+     */
+    std::string toSql() const;
+};
+
+#endif /* SqlAggregate_hpp */
@@ -6,148 +6,471 @@
 
 #include "SqlCondition.hpp"
 
-SqlCondition::SqlCondition(std::string field, std::string op, bool value)
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <sstream>
+
+SqlCondition::SqlCondition(std::string_view field, std::string op, bool value)
 {
-    if (!isValidOp(op))
-    {
-        throw std::runtime_error("Error in SqlCondition constructor. '" + op + "' is not a valid operator.");
-    }
-    
-    this->field = field;
-    this->op = op;
+    this->field = intern(field);
+    this->op = toOperator(op);
     this->value = value;
 }
 
-SqlCondition::SqlCondition(std::string field, std::string op, int value)
+SqlCondition::SqlCondition(std::string_view field, std::string op, int value)
 {
-    if (!isValidOp(op))
-    {
-        throw std::runtime_error("Error in SqlCondition constructor. '" + op + "' is not a valid operator.");
-    }
-    
-    this->field = field;
-    this->op = op;
+    this->field = intern(field);
+    this->op = toOperator(op);
     this->value = value;
 }
 
-SqlCondition::SqlCondition(std::string field, std::string op, double value)
+SqlCondition::SqlCondition(std::string_view field, std::string op, double value)
 {
-    if (!isValidOp(op))
-    {
-        throw std::runtime_error("Error in SqlCondition constructor. '" + op + "' is not a valid operator.");
-    }
-    
-    this->field = field;
-    this->op = op;
+    this->field = intern(field);
+    this->op = toOperator(op);
     this->value = value;
 }
 
-SqlCondition::SqlCondition(std::string field, std::string op, std::string value)
+SqlCondition::SqlCondition(std::string_view field, std::string op, std::string value)
 {
-    if (!isValidStrOp(op))
+    std::string opUpper;
+    for (std::string::iterator it = op.begin(); it != op.end(); it++)
     {
-        throw std::runtime_error("Error in SqlCondition constructor. '" + op + "' is not a valid operator.");
+        opUpper.push_back(std::toupper(*it));
     }
-    
-    this->field = field;
-    
-    if (op == "CONTAINS")
+
+    this->field = intern(field);
+
+    if (opUpper == "CONTAINS")
     {
-        this->op = "LIKE";
+        this->op = Like;
         this->value = "%" + value + "%";
     }
-    else if (op == "STARTSWITH")
+    else if (opUpper == "STARTSWITH")
     {
-        this->op = "LIKE";
+        this->op = Like;
         this->value = value + "%";
     }
-    else if (op == "ENDSWITH")
+    else if (opUpper == "ENDSWITH")
     {
-        this->op = "LIKE";
+        this->op = Like;
         this->value = "%" + value;
     }
     else
     {
-        this->op = op;
-        this->value = value;
+        this->op = toOperator(op);
+        this->value = std::move(value);
     }
 }
 
-SqlCondition::SqlCondition(std::string field, std::string op, const char *value)
+SqlCondition::SqlCondition(std::string_view field, std::string op, const char *value)
+    : SqlCondition(field, op, std::string(value))
 {
-    if (!isValidStrOp(op))
-    {
-        throw std::runtime_error("Error in SqlCondition constructor. '" + op + "' is not a valid operator.");
-    }
-    
-    this->field = field;
-    
-    if (op == "CONTAINS")
+
+}
+
+SqlCondition::SqlCondition(std::string_view field, std::string op, std::vector<std::string> value)
+{
+    checkVectorOp(op, value.size());
+
+    this->field = intern(field);
+    this->op = In;
+    if (value.size() > ARRAY_THRESHOLD)
     {
-        this->op = "LIKE";
-        this->value = "%" + std::string(value) + "%";
+        this->value = toJsonArray(value);
     }
-    else if (op == "STARTSWITH")
+    else
     {
-        this->op = "LIKE";
-        this->value = std::string(value) + "%";
+        this->value = SmallVector<std::string, INLINE_VALUES>(std::move(value));
     }
-    else if (op == "ENDSWITH")
+}
+
+SqlCondition::SqlCondition(std::string_view field, std::string op, std::vector<int> value)
+{
+    checkVectorOp(op, value.size());
+
+    this->field = intern(field);
+    this->op = In;
+    if (value.size() > ARRAY_THRESHOLD)
     {
-        this->op = "LIKE";
-        this->value = "%" + std::string(value);
+        this->value = toJsonArray(value);
     }
     else
     {
-        this->op = op;
-        this->value = std::string(value);
+        this->value = SmallVector<int, INLINE_VALUES>(std::move(value));
     }
 }
 
-SqlCondition::SqlCondition(std::string field, std::string op, std::vector<std::string> value)
+SqlCondition::SqlCondition(std::string_view field, std::string op, std::vector<double> value)
 {
-    if (!isValidVectorOp(op))
+    checkVectorOp(op, value.size());
+
+    this->field = intern(field);
+    this->op = In;
+    if (value.size() > ARRAY_THRESHOLD)
     {
-        throw std::runtime_error("Error in SqlCondition constructor. Only the operator 'IN' can be used if value is a vector.");
+        this->value = toJsonArray(value);
     }
-    if (value.empty())
+    else
     {
-        throw std::runtime_error("Error in SqlCondition constructor. Vector value cannot be empty.");
+        this->value = SmallVector<double, INLINE_VALUES>(std::move(value));
     }
-    
-    this->field = field;
+}
+
+SqlCondition::SqlCondition(Operator op, std::vector<SqlCondition> children)
+{
     this->op = op;
-    this->value = value;
+    this->children = std::move(children);
+}
+
+SqlCondition SqlCondition::allOf(std::vector<SqlCondition> conditions)
+{
+    return SqlCondition(And, std::move(conditions));
+}
+
+SqlCondition SqlCondition::anyOf(std::vector<SqlCondition> conditions)
+{
+    return SqlCondition(Or, std::move(conditions));
+}
+
+SqlCondition SqlCondition::negate(SqlCondition condition)
+{
+    return SqlCondition(Not, { std::move(condition) });
+}
+
+SqlCondition SqlCondition::between(std::string_view field, int low, int high)
+{
+    SqlCondition condition(Between, { });
+    condition.field = intern(field);
+    condition.value = SmallVector<int, INLINE_VALUES>({ low, high });
+    return condition;
+}
+
+SqlCondition SqlCondition::between(std::string_view field, double low, double high)
+{
+    SqlCondition condition(Between, { });
+    condition.field = intern(field);
+    condition.value = SmallVector<double, INLINE_VALUES>({ low, high });
+    return condition;
+}
+
+SqlCondition SqlCondition::between(std::string_view field, std::string low, std::string high)
+{
+    SqlCondition condition(Between, { });
+    condition.field = intern(field);
+    SmallVector<std::string, INLINE_VALUES> values;
+    values.push_back(std::move(low));
+    values.push_back(std::move(high));
+    condition.value = std::move(values);
+    return condition;
+}
+
+SqlCondition SqlCondition::isNull(std::string_view field)
+{
+    SqlCondition condition(IsNull, { });
+    condition.field = intern(field);
+    return condition;
+}
+
+SqlCondition SqlCondition::isNotNull(std::string_view field)
+{
+    SqlCondition condition(IsNotNull, { });
+    condition.field = intern(field);
+    return condition;
+}
+
+std::string SqlCondition::getShape() const
+{
+    std::string shape;
+    appendSql(shape);
+    return shape;
+}
+
+std::string SqlCondition::getKey() const
+{
+    std::string key = getShape();
+    appendValues(key);
+    return key;
 }
 
 SqlCondition::~SqlCondition()
 {
-    
+
 }
 
-bool SqlCondition::isValidOp(std::string op)
+void SqlCondition::appendSql(std::string &sql) const
 {
-    return op == "=" || op == "!=" || op == "<>" || op == ">" || op == ">=" || op == "<" || op == "<=";
+    switch (op)
+    {
+        case And:
+        case Or:
+            if (children.empty())
+            {
+                sql += op == And ? "1" : "0";
+                return;
+            }
+            sql += "(";
+            for (std::vector<SqlCondition>::const_iterator it = children.begin(); it != children.end(); it++)
+            {
+                if (it != children.begin())
+                {
+                    sql += op == And ? " AND " : " OR ";
+                }
+                it->appendSql(sql);
+            }
+            sql += ")";
+            break;
+        case Not:
+            sql += "NOT (";
+            children.front().appendSql(sql);
+            sql += ")";
+            break;
+        case Between:
+            sql += field;
+            sql += " BETWEEN ? AND ?";
+            break;
+        case IsNull:
+            sql += field;
+            sql += " IS NULL";
+            break;
+        case IsNotNull:
+            sql += field;
+            sql += " IS NOT NULL";
+            break;
+        case In:
+        {
+            sql += field;
+            if (std::holds_alternative<std::string>(value))
+            {
+                sql += " IN (SELECT value FROM json_each(?))";
+                break;
+            }
+            std::size_t size = 0;
+            if (const SmallVector<int, INLINE_VALUES> *ints = std::get_if<SmallVector<int, INLINE_VALUES>>(&value))
+            {
+                size = ints->size();
+            }
+            else if (const SmallVector<double, INLINE_VALUES> *doubles = std::get_if<SmallVector<double, INLINE_VALUES>>(&value))
+            {
+                size = doubles->size();
+            }
+            else
+            {
+                size = std::get<SmallVector<std::string, INLINE_VALUES>>(value).size();
+            }
+            sql += " IN (";
+            for (std::size_t i = 0; i < size; i++)
+            {
+                sql += i == 0 ? "?" : ",?";
+            }
+            sql += ")";
+            break;
+        }
+        default:
+            sql += field;
+            sql += " ";
+            sql += toSql(op);
+            sql += " ?";
+            break;
+    }
 }
 
-bool SqlCondition::isValidStrOp(std::string &op)
+void SqlCondition::appendValues(std::string &key) const
 {
-    std::string opUpper;
-    for (std::string::iterator it = op.begin(); it != op.end(); it++)
+    // Each value is tagged with its type, and strings with their length, so different values never give the same key.
+    std::ostringstream values;
+    values.precision(17);
+    if (const bool *boolValue = std::get_if<bool>(&value))
     {
-        opUpper.push_back(std::toupper(*it));
+        values << " b" << *boolValue;
+    }
+    else if (const int *intValue = std::get_if<int>(&value))
+    {
+        values << " i" << *intValue;
+    }
+    else if (const double *doubleValue = std::get_if<double>(&value))
+    {
+        values << " d" << *doubleValue;
+    }
+    else if (const std::string *text = std::get_if<std::string>(&value))
+    {
+        values << " s" << text->size() << ":" << *text;
+    }
+    else if (const SmallVector<int, INLINE_VALUES> *list = std::get_if<SmallVector<int, INLINE_VALUES>>(&value))
+    {
+        for (const int *it = list->begin(); it != list->end(); it++)
+        {
+            values << " i" << *it;
+        }
+    }
+    else if (const SmallVector<double, INLINE_VALUES> *list = std::get_if<SmallVector<double, INLINE_VALUES>>(&value))
+    {
+        for (const double *it = list->begin(); it != list->end(); it++)
+        {
+            values << " d" << *it;
+        }
+    }
+    else if (const SmallVector<std::string, INLINE_VALUES> *list = std::get_if<SmallVector<std::string, INLINE_VALUES>>(&value))
+    {
+        for (const std::string *it = list->begin(); it != list->end(); it++)
+        {
+            values << " s" << it->size() << ":" << *it;
+        }
+    }
+    key += values.str();
+
+    for (std::vector<SqlCondition>::const_iterator it = children.begin(); it != children.end(); it++)
+    {
+        it->appendValues(key);
     }
-    op = opUpper;
-    return isValidOp(op) || op == "CONTAINS" || op == "STARTSWITH" || op == "ENDSWITH";
 }
 
-bool SqlCondition::isValidVectorOp(std::string &op)
+SqlCondition::Operator SqlCondition::toOperator(const std::string &op)
+{
+    if (op == "=")
+    {
+        return Equal;
+    }
+    if (op == "!=" || op == "<>")
+    {
+        return NotEqual;
+    }
+    if (op == ">")
+    {
+        return Greater;
+    }
+    if (op == ">=")
+    {
+        return GreaterOrEqual;
+    }
+    if (op == "<")
+    {
+        return Less;
+    }
+    if (op == "<=")
+    {
+        return LessOrEqual;
+    }
+    throw std::runtime_error("Error in SqlCondition constructor. '" + op + "' is not a valid operator.");
+}
+
+const char * SqlCondition::toSql(Operator op)
+{
+    switch (op)
+    {
+        case Equal:
+            return "=";
+        case NotEqual:
+            return "!=";
+        case Greater:
+            return ">";
+        case GreaterOrEqual:
+            return ">=";
+        case Less:
+            return "<";
+        case LessOrEqual:
+            return "<=";
+        case Like:
+            return "LIKE";
+        default:
+            return "";
+    }
+}
+
+void SqlCondition::checkVectorOp(const std::string &op, std::size_t size)
 {
     std::string opUpper;
-    for (std::string::iterator it = op.begin(); it != op.end(); it++)
+    for (std::string::const_iterator it = op.begin(); it != op.end(); it++)
     {
         opUpper.push_back(std::toupper(*it));
     }
-    op = opUpper;
-    return op == "IN";
+    if (opUpper != "IN")
+    {
+        throw std::runtime_error("Error in SqlCondition constructor. Only the operator 'IN' can be used if value is a vector.");
+    }
+    if (size == 0)
+    {
+        throw std::runtime_error("Error in SqlCondition constructor. Vector value cannot be empty.");
+    }
+}
+
+std::string SqlCondition::toJsonArray(const std::vector<int> &values)
+{
+    std::string json = "[";
+    for (std::vector<int>::const_iterator it = values.begin(); it != values.end(); it++)
+    {
+        json += (it == values.begin() ? "" : ",") + std::to_string(*it);
+    }
+    return json + "]";
+}
+
+std::string SqlCondition::toJsonArray(const std::vector<double> &values)
+{
+    // Written with 17 significant digits and always with a decimal point or exponent, so each value reads back exactly, as a real.
+    std::ostringstream json;
+    json.precision(17);
+    json << std::showpoint << "[";
+    for (std::vector<double>::const_iterator it = values.begin(); it != values.end(); it++)
+    {
+        if (!std::isfinite(*it))
+        {
+            throw std::runtime_error("Error in SqlCondition constructor. The values of an IN condition must be finite.");
+        }
+        json << (it == values.begin() ? "" : ",") << *it;
+    }
+    json << "]";
+    return json.str();
+}
+
+std::string SqlCondition::toJsonArray(const std::vector<std::string> &values)
+{
+    std::string json = "[";
+    for (std::vector<std::string>::const_iterator it = values.begin(); it != values.end(); it++)
+    {
+        json += it == values.begin() ? "\"" : ",\"";
+        for (std::string::const_iterator c = it->begin(); c != it->end(); c++)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                json += '\\';
+                json += *c;
+            }
+            else if ((unsigned char)*c < 0x20)
+            {
+                char escaped[7];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)*c);
+                json += escaped;
+            }
+            else
+            {
+                json += *c;
+            }
+        }
+        json += '"';
+    }
+    return json + "]";
+}
+
+std::string_view SqlCondition::intern(std::string_view name)
+{
+    static std::shared_mutex mutex;
+    static std::set<std::string, std::less<>> names;
+
+    // Looked up by std::string_view, so a name that is already interned is not copied. Only adding a name needs the lock alone.
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        std::set<std::string, std::less<>>::iterator it = names.find(name);
+        if (it != names.end())
+        {
+            return *it;
+        }
+    }
+
+    // Another thread may have added the name since, in which case emplace() finds it.
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return *names.emplace(name).first;
 }
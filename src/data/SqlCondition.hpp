@@ -6,10 +6,14 @@
 #define SqlCondition_hpp
 
 #include <string>
-#include <any>
+#include <string_view>
+#include <type_traits>
+#include <variant>
 #include <vector>
 #include <stdexcept>
 
+#include "SmallVector.hpp"
+
 /**
  * @brief Class representing a condition in the WHERE clause of a SQL query.
  *
@@ -19,12 +23,28 @@
  *     ItemID = 123
  *     Price >= 2.00
  *
+ * Conditions can be combined into a tree with allOf(), anyOf(), and negate(). The tree is compiled to one WHERE clause, with a
+ * parameter for each value. For example, the orders of today and the open orders of any day:
+ *     SqlCondition::anyOf({ SqlCondition::between("orderDate", today, tomorrow), SqlCondition("status", "=", "ordered") })
+ * becomes:
+ *     (orderDate BETWEEN ? AND ? OR status = ?)
+ *
+ * An IN list with up to ARRAY_THRESHOLD values has a parameter for each value. A longer list is bound as one JSON array and
+ * compiled to:
+ *     field IN (SELECT value FROM json_each(?))
+ * so it is not limited by SQLite3's maximum number of parameters, and lists of any length share one prepared statement.
+ *
+ * Conditions are built and bound without allocating in the common case: the operator is an enum, the field name is interned
+ * once per distinct name, and the value is held in a std::variant, with up to INLINE_VALUES values of an IN list inside the
+ * object. Strings longer than the std::string small string buffer are the exception.
+ *
  * @author Julian Koksal
  * @date 2022-10-02
  */
 class SqlCondition
 {
     friend class DBHelper;
+    friend class SqlPage;
 public:
     /**
      * @brief Constructor creates a SqlCondition object initialized with the given values.
@@ -35,7 +55,7 @@ public:
      * @param op The operator.
      * @param value The value.
      */
-    SqlCondition(std::string field, std::string op, bool value);
+    SqlCondition(std::string_view field, std::string op, bool value);
     
     /**
      * @brief Constructor creates a SqlCondition object initialized with the given values.
@@ -46,7 +66,7 @@ public:
      * @param op The operator.
      * @param value The value.
      */
-    SqlCondition(std::string field, std::string op, int value);
+    SqlCondition(std::string_view field, std::string op, int value);
     
     /**
      * @brief Constructor creates a SqlCondition object initialized with the given values.
@@ -57,7 +77,7 @@ public:
      * @param op The operator.
      * @param value The value.
      */
-    SqlCondition(std::string field, std::string op, double value);
+    SqlCondition(std::string_view field, std::string op, double value);
     
     /**
      * @brief Constructor creates a SqlCondition object initialized with the given values.
@@ -68,7 +88,7 @@ public:
      * @param op The operator.
      * @param value The value.
      */
-    SqlCondition(std::string field, std::string op, std::string value);
+    SqlCondition(std::string_view field, std::string op, std::string value);
     
     /**
      * @brief Constructor creates a SqlCondition object initialized with the given values.
@@ -80,7 +100,7 @@ public:
      * @param op The operator.
      * @param value The value.
      */
-    SqlCondition(std::string field, std::string op, const char *value);
+    SqlCondition(std::string_view field, std::string op, const char *value);
     
     /**
      * @brief Constructor creates a SqlCondition object initialized with the given values.
@@ -91,7 +111,148 @@ public:
      * @param op The operator.
      * @param value The value.
      */
-    SqlCondition(std::string field, std::string op, std::vector<std::string> value);
+    SqlCondition(std::string_view field, std::string op, std::vector<std::string> value);
+    
+    /**
+     * @brief Constructor creates a SqlCondition object initialized with the given values.
+     *
+     * Throws a runtime exception if op is not "IN", or if value is empty.
+     *
+     * @param field The field (column name).
+     * @param op The operator.
+     * @param value The value.
+     */
+    SqlCondition(std::string_view field, std::string op, std::vector<int> value);
+    
+    /**
+     * @brief Constructor creates a SqlCondition object initialized with the given values.
+     *
+     * Throws a runtime exception if op is not "IN", or if value is empty. Also throws if value is longer than ARRAY_THRESHOLD and
+     * has a value that is not finite, since it is bound as JSON.
+     *
+     * @param field The field (column name).
+     * @param op The operator.
+     * @param value The value.
+     */
+    SqlCondition(std::string_view field, std::string op, std::vector<double> value);
+    
+    /**
+     * @brief Creates a condition that is true if all of the given conditions are true.
+     *
+     * True if conditions is empty.
+     *
+     * @param conditions The conditions.
+     * @return the condition
+     */
+    static SqlCondition allOf(std::vector<SqlCondition> conditions);
+    
+    /**
+     * @brief Creates a condition that is true if any of the given conditions is true.
+     *
+     * False if conditions is empty.
+     *
+     * @param conditions The conditions.
+     * @return the condition
+     */
+    static SqlCondition anyOf(std::vector<SqlCondition> conditions);
+    
+    /**
+     * @brief Creates a condition that is true if the given condition is false.
+     *
+     * @param condition The condition.
+     * @return the condition
+     */
+    static SqlCondition negate(SqlCondition condition);
+    
+    /**
+     * @brief Creates a condition that is true if the field is between low and high, inclusive.
+     *
+     * @param field The field (column name).
+     * @param low The lowest value.
+     * @param high The highest value.
+     * @return the condition
+     */
+    static SqlCondition between(std::string_view field, int low, int high);
+    
+    /**
+     * @brief Creates a condition that is true if the field is between low and high, inclusive.
+     *
+     * @param field The field (column name).
+     * @param low The lowest value.
+     * @param high The highest value.
+     * @return the condition
+     */
+    static SqlCondition between(std::string_view field, double low, double high);
+    
+    /**
+     * @brief Creates a condition that is true if the field is between low and high, inclusive.
+     *
+     * Strings are compared in SQLite3's BINARY collation, so dates formatted as "yyyy-MM-dd hh:mm:ss" are compared in time order.
+     *
+     * @param field The field (column name).
+     * @param low The lowest value.
+     * @param high The highest value.
+     * @return the condition
+     */
+    static SqlCondition between(std::string_view field, std::string low, std::string high);
+    
+    /**
+     * @brief Creates a condition that is true if the field is NULL.
+     *
+     * @param field The field (column name).
+     * @return the condition
+     */
+    static SqlCondition isNull(std::string_view field);
+    
+    /**
+     * @brief Creates a condition that is true if the field is not NULL.
+     *
+     * @param field The field (column name).
+     * @return the condition
+     */
+    static SqlCondition isNotNull(std::string_view field);
+    
+    /**
+     * @brief Gets the shape of the condition, which is the SQL it compiles to, with a ? in place of each value.
+     *
+     * Conditions with the same shape only differ in their values, so they share a prepared statement. An IN condition's shape
+     * includes the number of values.
+     *
+     * @return the shape, e.g. "(price BETWEEN ? AND ? OR name = ?)"
+     */
+    std::string getShape() const;
+    
+    /**
+     * @brief Gets a key that identifies the condition, including its values.
+     *
+     * Two conditions have the same key only if they select the same rows, so the key can be used to cache query results.
+     *
+     * @return the shape, followed by the type and value of each parameter
+     */
+    std::string getKey() const;
+    
+    /**
+     * @brief Copy constructor.
+     */
+    SqlCondition(const SqlCondition &other) = default;
+    
+    /**
+     * @brief Move constructor.
+     *
+     * Declared since the destructor would otherwise suppress it, and noexcept so that std::vector moves conditions rather than
+     * copying them when it grows.
+     */
+    SqlCondition(SqlCondition &&other) noexcept = default;
+    
+    /**
+     * @brief Copy assignment operator overload.
+     */
+    SqlCondition & operator=(const SqlCondition &other) = default;
+    
+    /**
+     * @brief Move assignment operator overload.
+     */
+    SqlCondition & operator=(SqlCondition &&other) noexcept = default;
     
     /**
      * @brief Destructor.
@@ -101,49 +262,153 @@ public:
     ~SqlCondition();
 private:
     /**
-     * @brief The name of the field (column) in the SQL table this condition applies to.
+     * @brief The operators a condition can have.
      */
-    std::string field;
+    enum Operator
+    {
+        Equal,
+        NotEqual,
+        Greater,
+        GreaterOrEqual,
+        Less,
+        LessOrEqual,
+        Like,
+        In,
+        Between,
+        IsNull,
+        IsNotNull,
+        And,
+        Or,
+        Not
+    };
     
     /**
-     * @brief A string representation of the operator of the condition. E.g. "=", ">=", "!=", etc
+     * @brief Number of values of an IN or BETWEEN condition that are kept inside the object rather than allocated.
      */
-    std::string op;
+    static const std::size_t INLINE_VALUES = 4;
     
     /**
-     * @brief The value that is compared to.
+     * @brief IN lists with more values than this are bound as one JSON array rather than one parameter per value.
      */
-    std::any value;
+    static const std::size_t ARRAY_THRESHOLD = 64;
     
     /**
-     * @brief Returns true if op is a valid operator. False otherwise.
-     *
-     * Valid operators: =, !=, <>, >, >=, <, <=
+     * @brief The value of a condition. std::monostate if it has none, e.g. IS NULL and conditions that combine other conditions.
+     */
+    typedef std::variant<std::monostate, bool, int, double, std::string, SmallVector<int, INLINE_VALUES>,
+                         SmallVector<double, INLINE_VALUES>, SmallVector<std::string, INLINE_VALUES>> Value;
+    
+    /**
+     * @brief The name of the field (column) in the SQL table this condition applies to. Interned, so it is never freed.
+     */
+    std::string_view field;
+    
+    /**
+     * @brief The operator of the condition.
+     */
+    Operator op;
+    
+    /**
+     * @brief The value that is compared to. For an IN list longer than ARRAY_THRESHOLD, the values as a JSON array.
+     */
+    Value value;
+    
+    /**
+     * @brief The conditions combined by And, Or, or Not, in order.
+     */
+    std::vector<SqlCondition> children;
+    
+    /**
+     * @brief Constructor creates a SqlCondition object that combines other conditions, or that has no value.
      *
      * @param op The operator.
-     * @return True if op is valid, false otherwise.
+     * @param children The conditions.
      */
-    bool isValidOp(std::string op);
+    SqlCondition(Operator op, std::vector<SqlCondition> children);
     
     /**
-     * @brief Changes op to uppercase, then returns true if op is a valid operator for strings.
+     * @brief Appends the SQL the condition compiles to, with a ? in place of each value.
      *
-     * Valid string operators: =, !=, <>, >, >=, <, <=, CONTAINS, STARTSWITH, ENDSWITH
+     * The values are bound in the same order by DBHelper::bindStatementConditions().
+     *
+     * @param sql The string to append to.
+     */
+    void appendSql(std::string &sql) const;
+    
+    /**
+     * @brief Appends the type and value of each parameter of the condition, in order.
+     *
+     * @param key The string to append to.
+     */
+    void appendValues(std::string &key) const;
+    
+    /**
+     * @brief Gets the operator written as op, for values that are not strings.
+     *
+     * Throws a runtime exception if op is not one of: =, !=, <>, >, >=, <, <=
      *
      * @param op The operator.
-     * @return True if op is valid, false otherwise.
+     * @return the operator
      */
-    bool isValidStrOp(std::string &op);
+    static Operator toOperator(const std::string &op);
     
     /**
-     * @brief Changes op to uppercase, then returns true if op is a valid operator for vectors.
+     * @brief Gets the SQL of an operator that compares a field to one value.
      *
-     * Valid vector operators: IN
+     * @param op The operator.
+     * @return the SQL, e.g. ">="
+     */
+    static const char * toSql(Operator op);
+    
+    /**
+     * @brief Checks that op is a valid operator for vectors.
+     *
+     * Throws a runtime exception if op is not IN, in any case, or if the vector is empty.
      *
      * @param op The operator.
-     * @return True if op is valid, false otherwise.
+     * @param size The number of values.
      */
-    bool isValidVectorOp(std::string &op);
+    static void checkVectorOp(const std::string &op, std::size_t size);
+    
+    /**
+     * @brief Formats values as a JSON array, which json_each() reads back as integers.
+     *
+     * @param values The values.
+     * @return the JSON array
+     */
+    static std::string toJsonArray(const std::vector<int> &values);
+    
+    /**
+     * @brief Formats values as a JSON array, which json_each() reads back as reals.
+     *
+     * Throws a runtime exception if a value is infinite or NaN, which JSON cannot represent.
+     *
+     * @param values The values.
+     * @return the JSON array
+     */
+    static std::string toJsonArray(const std::vector<double> &values);
+    
+    /**
+     * @brief Formats values as a JSON array of strings, which json_each() reads back as text.
+     *
+     * @param values The values.
+     * @return the JSON array
+     */
+    static std::string toJsonArray(const std::vector<std::string> &values);
+    
+    /**
+     * @brief Gets the interned copy of a field name, which stays valid until the program exits.
+     *
+     * Field names come from the code, so there are only a few of them, and a name is only added once. Looking up a name that
+     * was already added takes a shared lock, so threads do not wait for each other.
+     *
+     * @param name The field name.
+     * @return the interned field name
+     */
+    static std::string_view intern(std::string_view name);
 };
 
+// Moving a condition must not copy its values, which would allocate.
+static_assert(std::is_nothrow_move_constructible<SqlCondition>::value, "SqlCondition must be nothrow move constructible.");
+
 #endif /* SqlCondition_hpp */
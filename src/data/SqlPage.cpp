@@ -0,0 +1,58 @@
+//
+//  SqlPage.cpp
+//
+
+#include "SqlPage.hpp"
+
+SqlPage::SqlPage(int limit, int offset)
+{
+    if (limit < 0 || offset < 0)
+    {
+        throw std::runtime_error("Error in SqlPage constructor. The limit and offset cannot be negative.");
+    }
+    
+    this->limit = limit;
+    this->offset = offset;
+}
+
+SqlPage::~SqlPage()
+{
+    
+}
+
+SqlPage & SqlPage::after(std::string column, int value)
+{
+    cursor.push_back(SqlCondition(column, ">", value));
+    return *this;
+}
+
+SqlPage & SqlPage::after(std::string column, double value)
+{
+    cursor.push_back(SqlCondition(column, ">", value));
+    return *this;
+}
+
+SqlPage & SqlPage::after(std::string column, std::string value)
+{
+    cursor.push_back(SqlCondition(column, ">", value));
+    return *this;
+}
+
+std::string SqlPage::generateCursorComparison() const
+{
+    if (cursor.empty())
+    {
+        return "";
+    }
+    
+    std::string columns;
+    std::string parameters;
+    for (std::vector<SqlCondition>::const_iterator it = cursor.begin(); it != cursor.end(); it++)
+    {
+        columns += it->field;
+        columns += ",";
+        parameters += "?,";
+    }
+    
+    return "(" + columns.substr(0, columns.size() - 1) + ") > (" + parameters.substr(0, parameters.size() - 1) + ")";
+}
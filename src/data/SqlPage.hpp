@@ -0,0 +1,101 @@
+//
+//  SqlPage.hpp
+//
+
+#ifndef SqlPage_hpp
+#define SqlPage_hpp
+
+#include <string>
+#include <vector>
+
+#include "SqlCondition.hpp"
+
+/**
+ * @brief Class representing which page of the result of a select query to read, used by DBHelper::selectWhere().
+ *
+ * A page is up to limit rows, either skipping the first offset rows:
+ *     SqlPage(20, 40)                                     // LIMIT 20 OFFSET 40
+ * or, with a keyset cursor, starting after the last row of the previous page:
+ *     SqlPage(20).after("orderDate", date).after("orderNumber", number)
+ *                                                         // WHERE (orderDate, orderNumber) > (?, ?) LIMIT 20
+ *
+ * With a keyset cursor, the query must be sorted in ascending order of the cursor's columns, e.g. "orderDate, orderNumber",
+ * and the last of them should be unique. The cost of reading a page is then the same no matter how deep it is, while an offset
+ * still has to step over every row it skips.
+ *
+ * The default page has no limit, and reads every row.
+ */
+class SqlPage
+{
+    friend class DBHelper;
+public:
+    /**
+     * @brief Constructor creates a SqlPage object with the given limit and offset.
+     *
+     * Throws a runtime exception if limit or offset is negative.
+     *
+     * @param limit The maximum number of rows to read, or 0 for no limit.
+     * @param offset The number of rows to skip.
+     */
+    SqlPage(int limit = 0, int offset = 0);
+    
+    /**
+     * @brief Destructor.
+     *
+     * Does nothing.
+     */
+    ~SqlPage();
+    
+    /**
+     * @brief Adds a column to the keyset cursor. The page starts after the row whose cursor columns have the given values.
+     *
+     * Columns are compared in the order they are added.
+     *
+     * @param column The column name.
+     * @param value The value of the column in the last row of the previous page.
+     * @return this page, so calls can be chained
+     */
+    SqlPage & after(std::string column, int value);
+    
+    /**
+     * @brief Adds a column to the keyset cursor. The page starts after the row whose cursor columns have the given values.
+     *
+     * @param column The column name.
+     * @param value The value of the column in the last row of the previous page.
+     * @return this page, so calls can be chained
+     */
+    SqlPage & after(std::string column, double value);
+    
+    /**
+     * @brief Adds a column to the keyset cursor. The page starts after the row whose cursor columns have the given values.
+     *
+     * @param column The column name.
+     * @param value The value of the column in the last row of the previous page.
+     * @return this page, so calls can be chained
+     */
+    SqlPage & after(std::string column, std::string value);
+private:
+    /**
+     * @brief The maximum number of rows to read, or 0 for no limit.
+     */
+    int limit;
+    
+    /**
+     * @brief The number of rows to skip.
+     */
+    int offset;
+    
+    /**
+     * @brief The columns of the keyset cursor and their values, as ">" conditions so their values are bound the same way.
+     */
+    std::vector<SqlCondition> cursor;
+    
+    /**
+     * @brief Generates the row value comparison of the keyset cursor, e.g. "(orderDate,orderNumber) > (?,?)".
+     *
+     * @return the comparison, or an empty string if there is no cursor
+     */
+    std::string generateCursorComparison() const;
+};
+
+#endif /* SqlPage_hpp */
@@ -0,0 +1,80 @@
+//
+//  StatementCache.cpp
+//
+
+#include "StatementCache.hpp"
+
+StatementCache::StatementCache(int capacity) : capacity(capacity)
+{
+    this->hits = 0;
+    this->misses = 0;
+    this->size = 0;
+}
+
+StatementCache::~StatementCache()
+{
+    clear();
+}
+
+sqlite3_stmt * StatementCache::acquire(const std::string &query)
+{
+    std::unordered_map<std::string, std::list<std::pair<std::string, sqlite3_stmt *>>::iterator>::iterator found = index.find(query);
+    if (found == index.end())
+    {
+        misses++;
+        return NULL;
+    }
+
+    hits++;
+    sqlite3_stmt *statement = found->second->second;
+    entries.erase(found->second);
+    index.erase(found);
+    size--;
+
+    return statement;
+}
+
+void StatementCache::release(const std::string &query, sqlite3_stmt *statement)
+{
+    // Another statement with the same query text was released first, or caching is disabled.
+    if (capacity <= 0 || index.count(query))
+    {
+        sqlite3_finalize(statement);
+        return;
+    }
+
+    entries.emplace_front(query, statement);
+    index[query] = entries.begin();
+    size++;
+
+    // Evicts the least recently used statements.
+    while ((int)entries.size() > capacity)
+    {
+        index.erase(entries.back().first);
+        sqlite3_finalize(entries.back().second);
+        entries.pop_back();
+        size--;
+    }
+}
+
+void StatementCache::clear()
+{
+    for (std::list<std::pair<std::string, sqlite3_stmt *>>::iterator it = entries.begin(); it != entries.end(); it++)
+    {
+        sqlite3_finalize(it->second);
+    }
+    entries.clear();
+    index.clear();
+    size = 0;
+}
+
+StatementCache::Stats StatementCache::getStats() const
+{
+    Stats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.size = size;
+    stats.capacity = capacity;
+
+    return stats;
+}
@@ -0,0 +1,145 @@
+//
+//  StatementCache.hpp
+//
+
+#ifndef StatementCache_hpp
+#define StatementCache_hpp
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <atomic>
+
+#include "sqlite3.h"
+
+/**
+ * @brief Bounded LRU cache of prepared sqlite3 statements, keyed by their query text.
+ *
+ * Preparing a statement is often more expensive than running it, and DBHelper generates the same query text over and over.
+ * Statements are checked out of the cache with acquire() and handed back with release() once they have been stepped.
+ * A statement that is checked out is not in the cache, so two uses of the same query text never share a statement.
+ *
+ * When more than capacity statements are held, the least recently used one is finalized.
+ *
+ * A cache belongs to one database connection and is only used by the thread holding that connection.
+ * The counters are atomic, and the capacity is constant, so that DBConnectionPool can report them while the connection is in use
+ * by another thread.
+ */
+class StatementCache
+{
+public:
+    /**
+     * @brief Hit/miss counters and the current size of a statement cache.
+     */
+    struct Stats
+    {
+        /** Number of calls to acquire() that returned a cached statement. */
+        long long hits = 0;
+
+        /** Number of calls to acquire() that found no cached statement. */
+        long long misses = 0;
+
+        /** Number of statements currently held by the cache. */
+        int size = 0;
+
+        /** Maximum number of statements the cache will hold. */
+        int capacity = 0;
+    };
+
+    /**
+     * @brief Constructor.
+     *
+     * @param capacity the maximum number of statements to hold, 0 disables caching
+     */
+    StatementCache(int capacity);
+
+    /**
+     * @brief Destructor.
+     *
+     * Finalizes every statement held by the cache.
+     */
+    ~StatementCache();
+
+    /**
+     * @brief Checks a prepared statement out of the cache.
+     *
+     * The statement is removed from the cache until it is given back with release().
+     *
+     * @param query the query text the statement was prepared from
+     * @return the cached statement, or NULL if there is none and the caller must prepare it
+     */
+    sqlite3_stmt * acquire(const std::string &query);
+
+    /**
+     * @brief Gives a statement back to the cache, making it the most recently used.
+     *
+     * The statement should already have been reset with sqlite3_reset() and sqlite3_clear_bindings().
+     * If the same query text is already cached, or caching is disabled, the statement is finalized instead.
+     *
+     * @param query the query text the statement was prepared from
+     * @param statement the statement to cache
+     */
+    void release(const std::string &query, sqlite3_stmt *statement);
+
+    /**
+     * @brief Finalizes every statement held by the cache.
+     *
+     * Must be called before the database handle the statements belong to is closed.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the hit/miss counters and the current size of the cache.
+     *
+     * @return the cache stats
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * @brief The maximum number of statements the cache will hold.
+     */
+    const int capacity;
+
+    /**
+     * @brief The cached statements, most recently used first.
+     */
+    std::list<std::pair<std::string, sqlite3_stmt *>> entries;
+
+    /**
+     * @brief Maps query text to its position in entries.
+     */
+    std::unordered_map<std::string, std::list<std::pair<std::string, sqlite3_stmt *>>::iterator> index;
+
+    /**
+     * @brief Number of calls to acquire() that returned a cached statement.
+     */
+    std::atomic<long long> hits;
+
+    /**
+     * @brief Number of calls to acquire() that found no cached statement.
+     */
+    std::atomic<long long> misses;
+
+    /**
+     * @brief Number of statements in entries.
+     */
+    std::atomic<int> size;
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented, the cache owns its statements.
+     */
+    StatementCache(const StatementCache &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented, the cache owns its statements.
+     */
+    StatementCache& operator=(const StatementCache &other);
+};
+
+#endif /* StatementCache_hpp */
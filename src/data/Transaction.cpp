@@ -0,0 +1,49 @@
+//
+//  Transaction.cpp
+//
+
+#include "Transaction.hpp"
+
+Transaction::Transaction()
+{
+    DBHelper::getInstance().beginTransaction();
+    active = true;
+}
+
+Transaction::~Transaction()
+{
+    if (!active)
+    {
+        return;
+    }
+    
+    // Destructors must not throw, so a failed rollback is only reported.
+    try
+    {
+        DBHelper::getInstance().rollback();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error rolling back transaction. " << e.what() << std::endl;
+    }
+}
+
+void Transaction::commit()
+{
+    if (!active)
+    {
+        throw std::runtime_error("Error in call to Transaction::commit(). The transaction has already ended.");
+    }
+    active = false;
+    DBHelper::getInstance().commit();
+}
+
+void Transaction::rollback()
+{
+    if (!active)
+    {
+        throw std::runtime_error("Error in call to Transaction::rollback(). The transaction has already ended.");
+    }
+    active = false;
+    DBHelper::getInstance().rollback();
+}
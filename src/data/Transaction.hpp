@@ -0,0 +1,64 @@
+//
+//  Transaction.hpp
+//
+
+#ifndef Transaction_hpp
+#define Transaction_hpp
+
+#include "DBHelper.hpp"
+
+/**
+ * @brief RAII guard for a DBHelper transaction.
+ *
+ * The constructor begins a transaction on the calling thread. If the guard goes out of scope before commit() is called,
+ * for example because an exception was thrown, the transaction is rolled back.
+ * A guard created while another transaction is active on the same thread creates a nested savepoint instead.
+ *
+ * Example:
+ *     Transaction transaction;
+ *     db.update(orderDetail);
+ *     db.destroy(orderMaster);
+ *     transaction.commit();
+ */
+class Transaction
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * Begins a transaction, or a savepoint if a transaction is already active on this thread.
+     */
+    Transaction();
+
+    /**
+     * @brief Destructor.
+     *
+     * Rolls back if neither commit() nor rollback() was called.
+     */
+    ~Transaction();
+
+    /**
+     * @brief Commits the transaction, or releases the savepoint.
+     *
+     * Throws a runtime exception if the transaction has already ended.
+     */
+    void commit();
+
+    /**
+     * @brief Rolls back the transaction, or rolls back to the savepoint.
+     *
+     * Throws a runtime exception if the transaction has already ended.
+     */
+    void rollback();
+
+private:
+    /**
+     * @brief True until commit() or rollback() is called.
+     */
+    bool active;
+
+    Transaction(const Transaction &other) = delete;
+    Transaction& operator=(const Transaction &other) = delete;
+};
+
+#endif /* Transaction_hpp */
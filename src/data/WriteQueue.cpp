@@ -0,0 +1,118 @@
+//
+//  WriteQueue.cpp
+//
+
+#include "WriteQueue.hpp"
+
+#include <algorithm>
+
+#include "Transaction.hpp"
+
+const int WriteQueue::MAX_BATCH_SIZE = 256;
+
+WriteQueue * WriteQueue::instance = NULL;
+
+std::once_flag WriteQueue::instanceFlag;
+
+WriteQueue::WriteQueue()
+{
+    writer = std::thread([this] { work(); });
+}
+
+WriteQueue & WriteQueue::getInstance()
+{
+    std::call_once(instanceFlag, [] { instance = new WriteQueue(); });
+    return *instance;
+}
+
+WriteQueue::Stats WriteQueue::getStats()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void WriteQueue::enqueue(Write write)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(write));
+    }
+    writeAdded.notify_one();
+}
+
+void WriteQueue::work()
+{
+    std::vector<Write> batch;
+    while (true)
+    {
+        // Takes every write that arrived while the previous batch was being committed.
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            writeAdded.wait(lock, [this] { return !queue.empty(); });
+            while (!queue.empty() && (int)batch.size() < MAX_BATCH_SIZE)
+            {
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+
+        commitBatch(batch);
+        batch.clear();
+    }
+}
+
+void WriteQueue::commitBatch(std::vector<Write> &batch)
+{
+    std::vector<std::function<void()>> results(batch.size());
+    std::vector<std::exception_ptr> errors(batch.size());
+    try
+    {
+        Transaction transaction;
+        for (std::size_t i = 0; i < batch.size(); i++)
+        {
+            try
+            {
+                Transaction savepoint;
+                results[i] = batch[i].run();
+                savepoint.commit();
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+        transaction.commit();
+    }
+    catch (...)
+    {
+        // Nothing of the batch was committed, so the writes that succeeded fail with it.
+        std::exception_ptr error = std::current_exception();
+        for (std::size_t i = 0; i < batch.size(); i++)
+        {
+            if (!errors[i])
+            {
+                errors[i] = error;
+            }
+        }
+    }
+
+    // Counted before the futures are ready, so that a caller who has its result also sees it in the stats.
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.writes += batch.size();
+        stats.batches++;
+        stats.largestBatch = std::max(stats.largestBatch, (int)batch.size());
+    }
+
+    for (std::size_t i = 0; i < batch.size(); i++)
+    {
+        if (errors[i])
+        {
+            batch[i].fail(errors[i]);
+        }
+        else
+        {
+            results[i]();
+        }
+    }
+}
@@ -0,0 +1,225 @@
+//
+//  WriteQueue.hpp
+//
+
+#ifndef WriteQueue_hpp
+#define WriteQueue_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "DBHelper.hpp"
+
+/**
+ * @brief Process-wide queue of database writes, which a single writer thread commits in batches.
+ *
+ * SQLite3 lets one connection write at a time, so writers on different threads wait for each other's file lock, and each of them
+ * syncs the file when it commits. Instead, every session adds its writes to this queue and waits for the returned future. The
+ * writer thread takes all the writes that are waiting, up to MAX_BATCH_SIZE, and commits them in one transaction, so the more
+ * writes arrive while a batch is being committed, the more the next batch holds, and the cost of the commit is shared by all of them.
+ *
+ * Each write runs in a savepoint of the batch's transaction, so a write that throws is rolled back alone, and only its own future
+ * gets the exception. The futures are only made ready once the batch has been committed, so a caller never sees a write that may
+ * still be rolled back.
+ *
+ * The writes run on the writer thread, so a Transaction of the caller does not include them. A caller must not wait for a future
+ * while it has a transaction active, since the writer would then wait for the caller's lock.
+ *
+ * Thread-safe.
+ */
+class WriteQueue
+{
+public:
+    /**
+     * @brief Counts of the writes and batches committed since the program started.
+     */
+    struct Stats
+    {
+        /** Number of writes that were run, including those that threw. */
+        long long writes = 0;
+
+        /** Number of transactions the writes were committed in. */
+        long long batches = 0;
+
+        /** The most writes committed in one transaction. */
+        int largestBatch = 0;
+    };
+
+    /**
+     * @brief The most writes committed in one transaction. Default 256.
+     */
+    static const int MAX_BATCH_SIZE;
+
+    /**
+     * @brief Gets the singleton instance of this class.
+     *
+     * @return singleton instance of WriteQueue
+     */
+    static WriteQueue & getInstance();
+
+    /**
+     * @brief Adds a write to the queue. Returns without waiting for it.
+     *
+     * The write may make any number of DBHelper calls, which are committed together, and may use a Transaction of its own.
+     *
+     * @param write called on the writer thread, so it must only use the database and data that the caller does not change
+     * until the future is ready
+     * @return the result of write, or the exception it threw, once it has been committed
+     */
+    template<class T>
+    std::future<T> submit(std::function<T()> write)
+    {
+        std::shared_ptr<std::promise<T>> promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+
+        // The result is only set once the batch has been committed, so it is kept until then.
+        Write queued;
+        queued.run = [write, promise]() -> std::function<void()> {
+            if constexpr (std::is_void<T>::value)
+            {
+                write();
+                return [promise] { promise->set_value(); };
+            }
+            else
+            {
+                std::shared_ptr<T> result = std::make_shared<T>(write());
+                return [promise, result] { promise->set_value(std::move(*result)); };
+            }
+        };
+        queued.fail = [promise](std::exception_ptr error) { promise->set_exception(error); };
+        enqueue(std::move(queued));
+
+        return future;
+    }
+
+    /**
+     * @brief Adds an insert to the queue. See DBHelper::insert().
+     *
+     * @param model the model to insert, which is copied. Must inherit from Model.
+     * @return the key of the inserted record if it has an autogenerated INTEGER PRIMARY KEY, 0 otherwise
+     */
+    template<class T>
+    std::future<long long> insert(const T &model)
+    {
+        return submit<long long>([model] { return DBHelper::getInstance().insert(model); });
+    }
+
+    /**
+     * @brief Adds an update to the queue. See DBHelper::update().
+     *
+     * @param model the model to update, which is copied. Must inherit from Model.
+     * @return ready once the update has been committed
+     */
+    template<class T>
+    std::future<void> update(const T &model)
+    {
+        return submit<void>([model] { DBHelper::getInstance().update(model); });
+    }
+
+    /**
+     * @brief Gets the counts of the writes and batches committed so far.
+     *
+     * @return the stats
+     */
+    Stats getStats();
+
+private:
+    /**
+     * @brief A write in the queue.
+     */
+    struct Write
+    {
+        /** Runs the write, and returns what makes its future ready once it has been committed. */
+        std::function<std::function<void()>()> run;
+
+        /** Makes the future of the write ready with an exception. */
+        std::function<void(std::exception_ptr)> fail;
+    };
+
+    /**
+     * @brief Singleton instance of WriteQueue.
+     */
+    static WriteQueue *instance;
+
+    /**
+     * @brief Ensures the singleton instance is only created once.
+     */
+    static std::once_flag instanceFlag;
+
+    /**
+     * @brief Held while queue and stats are used.
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief Notified when a write is added to queue.
+     */
+    std::condition_variable writeAdded;
+
+    /**
+     * @brief The writes that have not been run yet, in the order they were added.
+     */
+    std::deque<Write> queue;
+
+    /**
+     * @brief Counts of the writes and batches committed so far.
+     */
+    Stats stats;
+
+    /**
+     * @brief The writer thread.
+     */
+    std::thread writer;
+
+    /**
+     * @brief Constructor.
+     *
+     * Starts the writer thread.
+     */
+    WriteQueue();
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented to prevent copying of singleton instance.
+     */
+    WriteQueue(const WriteQueue &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented to prevent assignment of singleton instance.
+     */
+    WriteQueue& operator=(const WriteQueue &other);
+
+    /**
+     * @brief Adds a write to the queue and wakes the writer thread.
+     *
+     * @param write the write
+     */
+    void enqueue(Write write);
+
+    /**
+     * @brief Commits the writes in the queue in batches, waiting for more when it is empty. Run by the writer thread.
+     */
+    void work();
+
+    /**
+     * @brief Runs a batch of writes in one transaction, each in its own savepoint, then makes their futures ready.
+     *
+     * If the transaction cannot be begun or committed, every write of the batch gets the exception.
+     *
+     * @param batch the writes
+     */
+    void commitBatch(std::vector<Write> &batch);
+};
+
+#endif /* WriteQueue_hpp */
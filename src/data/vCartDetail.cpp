@@ -0,0 +1,89 @@
+//
+//  vCartDetail.cpp
+//
+
+#include "vCartDetail.hpp"
+
+vCartDetail::vCartDetail(int orderDetailID, int orderNumber, std::string menuItemName, int quantity, double price, double total,
+                         std::string sessionID, std::string status)
+{
+    this->orderDetailID = orderDetailID;
+    this->orderNumber = orderNumber;
+    this->menuItemName = menuItemName;
+    this->quantity = quantity;
+    this->price = price;
+    this->total = total;
+    this->sessionID = sessionID;
+    this->status = status;
+}
+
+vCartDetail::~vCartDetail()
+{
+    
+}
+
+int vCartDetail::getOrderDetailID() {
+    return orderDetailID;
+}
+
+int vCartDetail::getOrderNumber() {
+    return orderNumber;
+}
+
+std::string vCartDetail::getMenuItemName() {
+    return menuItemName;
+}
+
+int vCartDetail::getQuantity() {
+    return quantity;
+}
+
+double vCartDetail::getPrice() {
+    return price;
+}
+
+double vCartDetail::getTotal()
+{
+    return total;
+}
+
+std::string vCartDetail::getSessionID()
+{
+    return sessionID;
+}
+
+std::string vCartDetail::getStatus()
+{
+    return status;
+}
+
+
+std::string vCartDetail::tableName() const
+{
+    return "vCartDetail";
+}
+
+std::vector<std::string> vCartDetail::columns() const
+{
+    return Schema::names(schema());
+}
+
+std::set<std::string> vCartDetail::keys() const
+{
+    return { columns()[0] };
+}
+
+bool vCartDetail::isAutoGeneratedKey() const
+{
+    return false;
+}
+
+int vCartDetail::bindColumn(sqlite3_stmt *statement, int index, int column) const
+{
+    return Schema::bind(*this, schema(), column, statement, index);
+}
+
+void vCartDetail::readColumn(sqlite3_stmt *statement, int index, int column)
+{
+    Schema::read(*this, schema(), column, statement, index);
+}
@@ -0,0 +1,165 @@
+//
+//  vCartDetail.hpp
+//
+
+#ifndef vCartDetail_hpp
+#define vCartDetail_hpp
+
+#include <string>
+#include <tuple>
+
+#include "Model.hpp"
+#include "Schema.hpp"
+
+/**
+ * @brief Class representing a row of the vCartDetail view.
+ *
+ * An order detail together with the price of its menu item and the session and status of its order.
+ * Lets a session's cart, with every line's price and total, be read with a single query.
+ */
+class vCartDetail : public Model
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * Creates an object initialized with the given values.
+     *
+     * @param orderDetailID the value to initialize orderDetailID with
+     * @param orderNumber the value to initialize orderNumber with
+     * @param menuItemName the value to initialize menuItemName with
+     * @param quantity the value to initialize quantity with
+     * @param price the value to initialize price with
+     * @param total the value to initialize total with
+     * @param sessionID the value to initialize sessionID with
+     * @param status the value to initialize status with
+     */
+    vCartDetail(int orderDetailID = 0, int orderNumber = 0, std::string menuItemName = "", int quantity = 0, double price = 0, double total = 0,
+                std::string sessionID = "", std::string status = "");
+
+    /**
+     * @brief Destructor.
+     *
+     * Does nothing.
+     */
+    ~vCartDetail();
+    
+    /**
+     * @brief Gets orderDetailID.
+     *
+     * @return orderDetailID
+     */
+    int getOrderDetailID();
+    
+    /**
+     * @brief Gets orderNumber.
+     *
+     * @return orderNumber
+     */
+    int getOrderNumber();
+    
+    /**
+     * @brief Gets menuItemName.
+     *
+     * @return menuItemName
+     */
+    std::string getMenuItemName();
+    
+    /**
+     * @brief Gets quantity.
+     *
+     * @return quantity
+     */
+    int getQuantity();
+    
+    /**
+     * @brief Gets price.
+     *
+     * @return price
+     */
+    double getPrice();
+    
+    /**
+     * @brief Gets total.
+     *
+     * @return total
+     */
+    double getTotal();
+    
+    /**
+     * @brief Gets sessionID.
+     *
+     * @return sessionID
+     */
+    std::string getSessionID();
+    
+    /**
+     * @brief Gets status.
+     *
+     * @return status
+     */
+    std::string getStatus();
+
+private:
+    /**
+     * @brief The ID of the OrderDetail.
+     */
+    int orderDetailID;
+    
+    /**
+     * @brief The order number of the OrderMaster this detail belongs to.
+     */
+    int orderNumber;
+    
+    /**
+     * @brief The name of the menu item.
+     */
+    std::string menuItemName;
+    
+    /**
+     * @brief The quantity of the menu item in the order.
+     */
+    int quantity;
+    
+    /**
+     * @brief The price of the menu item, 0 if it is no longer on the menu.
+     */
+    double price;
+    
+    /**
+     * @brief The total price, equal to quantity multiplied by price.
+     */
+    double total;
+    
+    /**
+     * @brief The ID of the session that placed the order.
+     */
+    std::string sessionID;
+    
+    /**
+     * @brief The status of the order, e.g. "cart".
+     */
+    std::string status;
+    
+    virtual std::string tableName() const override;
+    virtual std::vector<std::string> columns() const override;
+    virtual std::set<std::string> keys() const override;
+    virtual bool isAutoGeneratedKey() const override;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const override;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) override;
+    
+    /** The columns of the table, in order, and the member variables that hold their values. */
+    static constexpr auto schema()
+    {
+        return std::make_tuple(Schema::column("orderDetailID", &vCartDetail::orderDetailID),
+                               Schema::column("orderNumber", &vCartDetail::orderNumber),
+                               Schema::column("menuItemName", &vCartDetail::menuItemName),
+                               Schema::column("quantity", &vCartDetail::quantity),
+                               Schema::column("price", &vCartDetail::price),
+                               Schema::column("total", &vCartDetail::total),
+                               Schema::column("sessionID", &vCartDetail::sessionID),
+                               Schema::column("status", &vCartDetail::status));
+    }
+};
+
+#endif /* vCartDetail_hpp */
@@ -55,7 +55,7 @@ std::string vOrderDetail::tableName() const
 
 std::vector<std::string> vOrderDetail::columns() const
 {
-    return { "orderDetailID", "orderNumber", "menuItemName", "quantity", "price", "total" };
+    return Schema::names(schema());
 }
 
 std::set<std::string> vOrderDetail::keys() const
@@ -68,28 +68,12 @@ bool vOrderDetail::isAutoGeneratedKey() const
     return false;
 }
 
-std::map<std::string, std::any> vOrderDetail:: toMap() const
+int vOrderDetail::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = orderDetailID;
-    mMap[columns()[1]] = orderNumber;
-    mMap[columns()[2]] = menuItemName;
-    mMap[columns()[3]] = quantity;
-    mMap[columns()[4]] = price;
-    mMap[columns()[5]] = total;
-
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * vOrderDetail::fromMap(std::map<std::string, std::any> mMap) const
+void vOrderDetail::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-    int mOrderDetailID = std::any_cast<int>(mMap[columns()[0]]);
-    int mOrderNumber = std::any_cast<int>(mMap[columns()[1]]);
-    std::string mName = std::any_cast<std::string>(mMap[columns()[2]]);
-    int mQuantity = std::any_cast<int>(mMap[columns()[3]]);
-    double mPrice = std::any_cast<double>(mMap[columns()[4]]);
-    double mTotal = std::any_cast<double>(mMap[columns()[5]]);
-    vOrderDetail *model = new vOrderDetail(mOrderDetailID, mOrderNumber, mName, mQuantity, mPrice, mTotal);
-
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
@@ -6,9 +6,10 @@
 #define vOrderDetail_hpp
 
 #include <string>
-#include <map>
+#include <tuple>
 
 #include "Model.hpp"
+#include "Schema.hpp"
 
 /**
  * @brief Class representing a row of the vOrderDetail view.
@@ -117,8 +118,19 @@ private:
     virtual std::vector<std::string> columns() const override;
     virtual std::set<std::string> keys() const override;
     virtual bool isAutoGeneratedKey() const override;
-    virtual std::map<std::string, std::any> toMap() const override;
-    virtual Model * fromMap(std::map<std::string, std::any> mMap) const override;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const override;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) override;
+    
+    /** The columns of the table, in order, and the member variables that hold their values. */
+    static constexpr auto schema()
+    {
+        return std::make_tuple(Schema::column("orderDetailID", &vOrderDetail::orderDetailID),
+                               Schema::column("orderNumber", &vOrderDetail::orderNumber),
+                               Schema::column("menuItemName", &vOrderDetail::menuItemName),
+                               Schema::column("quantity", &vOrderDetail::quantity),
+                               Schema::column("price", &vOrderDetail::price),
+                               Schema::column("total", &vOrderDetail::total));
+    }
 };
 
 #endif /* vOrderDetail_hpp */
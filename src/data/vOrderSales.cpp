@@ -53,7 +53,7 @@ std::string vOrderSales::tableName() const
 
 std::vector<std::string> vOrderSales::columns() const
 {
-    return { "salesDate", "menuItemName", "totalQuantity", "totalRevenue", "isAllMenuItems" };
+    return Schema::names(schema());
 }
 
 std::set<std::string> vOrderSales::keys() const
@@ -66,26 +66,12 @@ bool vOrderSales::isAutoGeneratedKey() const
     return false;
 }
 
-std::map<std::string, std::any> vOrderSales:: toMap() const
+int vOrderSales::bindColumn(sqlite3_stmt *statement, int index, int column) const
 {
-    std::map<std::string, std::any> mMap;
-    mMap[columns()[0]] = salesDate;
-    mMap[columns()[1]] = menuItemName;
-    mMap[columns()[2]] = totalQuantity;
-    mMap[columns()[3]] = totalRevenue;
-    mMap[columns()[4]] = isAllMenuItems;
-
-    return mMap;
+    return Schema::bind(*this, schema(), column, statement, index);
 }
 
-Model * vOrderSales::fromMap(std::map<std::string, std::any> mMap) const
+void vOrderSales::readColumn(sqlite3_stmt *statement, int index, int column)
 {
-    std::string mSalesDate = std::any_cast<std::string>(mMap[columns()[0]]);
-    std::string mMenuItemName = std::any_cast<std::string>(mMap[columns()[1]]);
-    int mTotalQuantity = std::any_cast<int>(mMap[columns()[2]]);
-    double mTotalRevenue = std::any_cast<double>(mMap[columns()[3]]);
-    bool mIsAllMenuItems = std::any_cast<int>(mMap[columns()[4]]);
-    vOrderSales *model = new vOrderSales(mSalesDate, mMenuItemName, mTotalQuantity, mTotalRevenue, mIsAllMenuItems);
-
-    return model;
+    Schema::read(*this, schema(), column, statement, index);
 }
@@ -6,9 +6,10 @@
 #define vOrderSales_hpp
 
 #include <string>
-#include <map>
+#include <tuple>
 
 #include "Model.hpp"
+#include "Schema.hpp"
 
 /**
  * @brief Class representing a row of the vOrderSales view.
@@ -110,8 +111,18 @@ private:
     virtual std::vector<std::string> columns() const override;
     virtual std::set<std::string> keys() const override;
     virtual bool isAutoGeneratedKey() const override;
-    virtual std::map<std::string, std::any> toMap() const override;
-    virtual Model * fromMap(std::map<std::string, std::any> mMap) const override;
+    virtual int bindColumn(sqlite3_stmt *statement, int index, int column) const override;
+    virtual void readColumn(sqlite3_stmt *statement, int index, int column) override;
+    
+    /** The columns of the table, in order, and the member variables that hold their values. */
+    static constexpr auto schema()
+    {
+        return std::make_tuple(Schema::column("salesDate", &vOrderSales::salesDate),
+                               Schema::column("menuItemName", &vOrderSales::menuItemName),
+                               Schema::column("totalQuantity", &vOrderSales::totalQuantity),
+                               Schema::column("totalRevenue", &vOrderSales::totalRevenue),
+                               Schema::column("isAllMenuItems", &vOrderSales::isAllMenuItems));
+    }
 };
 
 
@@ -0,0 +1,283 @@
+//
+//  BenchmarkDBHelper.cpp
+//
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "DBConfig.hpp"
+#include "DBHelper.hpp"
+#include "MenuItem.hpp"
+#include "OrderDetail.hpp"
+#include "SalesCache.hpp"
+#include "vOrderSales.hpp"
+#include "Transaction.hpp"
+
+/**
+ * @brief Number of calls to operator new since the program started.
+ */
+static std::atomic<long long> allocationCount(0);
+
+/**
+ * @brief Number of bytes currently allocated with operator new.
+ */
+static std::atomic<long long> bytesInUse(0);
+
+/**
+ * @brief The highest value of bytesInUse since it was last reset.
+ */
+static std::atomic<long long> peakBytesInUse(0);
+
+/**
+ * @brief Space reserved in front of each allocation to remember its size. Keeps the returned memory aligned.
+ */
+static const std::size_t headerSize = alignof(std::max_align_t);
+
+/**
+ * @brief Counts every heap allocation made by the program and the bytes in use, then allocates as usual.
+ */
+void * operator new(std::size_t size)
+{
+    char *block = (char *)std::malloc(size + headerSize);
+    if (block == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    *(std::size_t *)block = size;
+
+    allocationCount++;
+    long long inUse = bytesInUse += size;
+    long long peak = peakBytesInUse;
+    while (inUse > peak && !peakBytesInUse.compare_exchange_weak(peak, inUse))
+    {
+    }
+
+    return block + headerSize;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (pointer == NULL)
+    {
+        return;
+    }
+    char *block = (char *)pointer - headerSize;
+    bytesInUse -= *(std::size_t *)block;
+    std::free(block);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+/**
+ * @brief Measures the heap allocations and time taken by a block of code.
+ */
+class Measurement
+{
+public:
+    Measurement()
+    {
+        allocations = allocationCount;
+        bytesAtStart = bytesInUse;
+        peakBytesInUse = bytesAtStart;
+        start = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Prints the allocations and time taken since construction, in total and per row, and the peak memory used.
+     *
+     * @param name the name of what was measured
+     * @param rows the number of rows processed
+     */
+    void print(const std::string &name, long long rows) const
+    {
+        long long allocated = allocationCount - allocations;
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(28) << name;
+        std::cout << std::right << std::setw(10) << rows << " rows";
+        std::cout << std::setw(12) << allocated << " allocs";
+        std::cout << std::setw(8) << std::fixed << std::setprecision(2) << (double)allocated / rows << " allocs/row";
+        std::cout << std::setw(10) << std::setprecision(1) << milliseconds << " ms";
+        std::cout << std::setw(10) << (peakBytesInUse - bytesAtStart) / 1024 << " KiB peak" << std::endl;
+    }
+
+private:
+    long long allocations;
+    long long bytesAtStart;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Formats the date daysAgo days before today the same way as vOrderSales.salesDate.
+ *
+ * @param daysAgo the number of days before today
+ * @return the date, formatted as "yyyy-mm-dd 00:00:00"
+ */
+std::string salesDateDaysAgo(int daysAgo)
+{
+    std::time_t now = std::time(NULL);
+    std::tm day = *std::localtime(&now);
+    day.tm_mday -= daysAgo;
+    std::mktime(&day);
+
+    char dayStr[20];
+    std::strftime(dayStr, 20, "%Y-%m-%d 00:00:00", &day);
+    return std::string(dayStr);
+}
+
+/**
+ * @brief Benchmarks DBHelper's row marshalling, counting heap allocations per row.
+ *
+ * Inserts rowCount OrderDetail rows into a single order, then reads them back with DBHelper::selectWhere() and
+ * DBHelper::forEachWhere().
+ * Everything runs inside a transaction that is rolled back at the end, so the database is left unchanged.
+ * README.txt lists what these took when rows were still marshalled through a std::map of std::any values.
+ *
+ * @param db the database
+ * @param rowCount the number of rows to insert and read
+ */
+void benchmarkRows(const DBHelper &db, int rowCount)
+{
+    // An order number that no real order uses.
+    const int orderNumber = -1;
+    const std::string menuItemNames[] = { "Coffee", "Cappuccino", "Lunch Combo 1", "Breakfast Combo" };
+
+    std::vector<OrderDetail> details;
+    details.reserve(rowCount);
+    for (int i = 0; i < rowCount; i++)
+    {
+        details.push_back(OrderDetail(0, orderNumber, menuItemNames[i % 4], i % 5 + 1));
+    }
+
+    Transaction transaction;
+    {
+        Measurement measurement;
+        db.insertMany(details);
+        measurement.print("insertMany", rowCount);
+    }
+    {
+        Measurement measurement;
+        std::vector<OrderDetail> result = db.selectWhere(OrderDetail(), { SqlCondition("orderNumber", "=", orderNumber) });
+        measurement.print("selectWhere, all columns", result.size());
+    }
+    {
+        Measurement measurement;
+        std::vector<OrderDetail> result = db.selectWhere(OrderDetail(), { SqlCondition("orderNumber", "=", orderNumber) }, "",
+                                                         { "quantity" });
+        measurement.print("selectWhere, one column", result.size());
+    }
+    {
+        Measurement measurement;
+        long long totalQuantity = 0;
+        long long rows = db.forEachWhere(OrderDetail(), { SqlCondition("orderNumber", "=", orderNumber) },
+                                         [&totalQuantity](OrderDetail &row) { totalQuantity += row.getQuantity(); });
+        measurement.print("forEachWhere, all columns", rows);
+    }
+    transaction.rollback();
+}
+
+/**
+ * @brief Benchmarks the queries the sales page uses to chart the last year of sales.
+ *
+ * Compares one query per day against one query for the whole date range, pivoted into a table of days by menu items,
+ * and against the shared SalesCache.
+ * Run TestDataGenerator first so there is a year of orders to read.
+ *
+ * @param db the database
+ */
+void benchmarkSalesChart(const DBHelper &db)
+{
+    const int numDays = 366;
+
+    std::vector<MenuItem> menu = db.selectWhere(MenuItem(), {}, "name");
+    std::map<std::string, int> seriesColumns;
+    seriesColumns["All menu items"] = 0;
+    for (int i = 0; i < menu.size(); i++)
+    {
+        seriesColumns[menu[i].getName()] = i + 1;
+    }
+
+    {
+        Measurement measurement;
+        long long rows = 0;
+        for (int daysAgo = 1; daysAgo <= numDays; daysAgo++)
+        {
+            rows += db.selectWhere(vOrderSales(), { SqlCondition("salesDate", "=", salesDateDaysAgo(daysAgo)) },
+                                   "isAllMenuItems DESC, menuItemName").size();
+        }
+        measurement.print("sales chart, query per day", rows);
+    }
+    {
+        Measurement measurement;
+        // Revenue for each day and series.
+        std::vector<std::vector<double>> revenue(numDays, std::vector<double>(menu.size() + 1, 0.0));
+        std::map<std::string, int> daySeqs;
+        for (int daysAgo = 1; daysAgo <= numDays; daysAgo++)
+        {
+            daySeqs[salesDateDaysAgo(daysAgo)] = numDays - daysAgo;
+        }
+
+        std::string salesDate;
+        int daySeq = 0;
+        long long rows = db.forEachWhere(vOrderSales(), { SqlCondition("salesDate", ">=", salesDateDaysAgo(numDays)),
+                                                          SqlCondition("salesDate", "<=", salesDateDaysAgo(1)) },
+                                         [&](vOrderSales &sales) {
+            // The rows are ordered by date, so each date is only looked up once.
+            if (sales.getSalesDate() != salesDate)
+            {
+                salesDate = sales.getSalesDate();
+                daySeq = daySeqs[salesDate];
+            }
+            std::map<std::string, int>::iterator column = seriesColumns.find(sales.getMenuItemName());
+            if (column != seriesColumns.end())
+            {
+                revenue[daySeq][column->second] = sales.getTotalRevenue();
+            }
+        }, "salesDate");
+        measurement.print("sales chart, ranged query", rows);
+    }
+    {
+        Measurement measurement;
+        SalesCache::getInstance().invalidate();
+        SalesCache::getInstance().get(salesDateDaysAgo(numDays), numDays);
+        measurement.print("sales chart, cache rebuilt", numDays);
+    }
+    {
+        Measurement measurement;
+        SalesCache::getInstance().get(salesDateDaysAgo(numDays), numDays);
+        measurement.print("sales chart, cache hit", numDays);
+    }
+}
+
+/**
+ * @brief Benchmarks DBHelper, printing the heap allocations, time, and peak memory of each operation.
+ *
+ * Usage: BenchmarkDBHelper [--db-path=sql/data.db] [rowCount]
+ *
+ * @param argc number of command line args
+ * @param argv command line args, see DBConfig::fromArgs() for the database options
+ */
+int main(int argc, char *argv[])
+{
+    DBHelper::configure(DBConfig::fromArgs(argc, argv));
+    int rowCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    const DBHelper &db = DBHelper::getInstance();
+
+    benchmarkRows(db, rowCount);
+    benchmarkSalesChart(db);
+
+    return 0;
+}
@@ -7,9 +7,14 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "DBHelper.hpp"
+#include "MenuCache.hpp"
 #include "MenuItem.hpp"
+#include "MenuItemIngredient.hpp"
+#include "OrderDetail.hpp"
+#include "Transaction.hpp"
 
 /**
  * @brief Prints the menu neatly formatted.
@@ -91,6 +96,117 @@ int main(int argc, const char *argv[])
     menu = db.selectWhere(MenuItem(), {SqlCondition("name", "IN", std::vector<std::string>({ "Coffee", "Latte" }))});
     printMenu(menu, "Menu where name in ('Coffee', 'Latte'), unsorted.");
 
+    // Rows can also be read one at a time, without building a vector of the whole result.
+    double totalPrice = 0;
+    long long rowCount = db.forEachWhere(MenuItem(), {SqlCondition("name", "CONTAINS", "combo")},
+                                         [&totalPrice](MenuItem &item) { totalPrice += item.getPrice(); });
+    std::cout << "Total price of the " << rowCount << " items where name contains 'combo': $" << totalPrice << std::endl << std::endl;
+
+    // --- Aggregates ---
+
+    // Counts, existence checks, and aggregates are computed by SQLite3, so no rows are read into memory.
+    std::cout << "Number of items where price >= 3.00: " << db.count(MenuItem(), {SqlCondition("price", ">=", 3.00)}) << std::endl;
+    std::cout << "Cookie is on the menu: " << db.exists(MenuItem(), {SqlCondition("name", "=", "Cookie")}) << std::endl;
+    std::cout << "Tea is on the menu: " << db.exists(MenuItem(), {SqlCondition("name", "=", "Tea")}) << std::endl;
+    std::tuple<double, double, double> prices = db.aggregate<double, double, double>(MenuItem(),
+        {SqlAggregate("MIN", "price"), SqlAggregate("MAX", "price"), SqlAggregate("AVG", "price")})[0];
+    std::cout << "Min, max, and average price: $" << std::get<0>(prices) << ", $" << std::get<1>(prices) << ", $" << std::get<2>(prices);
+    std::cout << std::endl;
+    std::vector<std::tuple<double, long long>> priceCounts = db.aggregate<double, long long>(MenuItem(),
+        {SqlAggregate("price"), SqlAggregate("COUNT", "*")}, {}, "price");
+    std::cout << "Number of items at each price:" << std::endl;
+    for (int i = 0; i < priceCounts.size(); i++) {
+        std::cout << "  $" << std::get<0>(priceCounts[i]) << ": " << std::get<1>(priceCounts[i]) << std::endl;
+    }
+    std::cout << std::endl;
+
+    // --- Paging ---
+
+    menu = db.selectWhere(MenuItem(), {}, "price,name", {}, SqlPage(3));
+    printMenu(menu, "First page of 3 items, sorted by ascending price, then name:");
+
+    menu = db.selectWhere(MenuItem(), {}, "price,name", {}, SqlPage(3, 3));
+    printMenu(menu, "Second page of 3 items, skipping the first page with an offset:");
+
+    // A keyset cursor starts right after the last row of the previous page, without stepping over the rows before it.
+    menu = db.selectWhere(MenuItem(), {}, "price,name", {}, SqlPage(3));
+    menu = db.selectWhere(MenuItem(), {}, "price,name", {}, SqlPage(3).after("price", menu.back().getPrice()).after("name", menu.back().getName()));
+    printMenu(menu, "Second page of 3 items, starting after the last item of the first page:");
+
+    // --- Condition trees ---
+
+    // One query instead of one per alternative.
+    SqlCondition drinksOrCookies = SqlCondition::anyOf({ SqlCondition::between("price", 2.00, 3.00),
+                                                         SqlCondition("name", "CONTAINS", "cookie") });
+    menu = db.selectWhere(MenuItem(), { drinksOrCookies }, "price,name");
+    printMenu(menu, "Items between $2.00 and $3.00, or cookies: " + drinksOrCookies.getShape());
+
+    SqlCondition notCombos = SqlCondition::allOf({ SqlCondition::negate(SqlCondition("name", "CONTAINS", "combo")),
+                                                   SqlCondition::isNotNull("description") });
+    menu = db.selectWhere(MenuItem(), { notCombos }, "price,name");
+    printMenu(menu, "Items that are not combos: " + notCombos.getShape());
+
+    menu = db.selectWhere(MenuItem(), { SqlCondition("price", "IN", std::vector<int>({ 3, 10 })) }, "name");
+    printMenu(menu, "Items that cost exactly $3 or $10:");
+
+    // The shape only depends on the structure of the condition, the key also depends on its values.
+    SqlCondition otherPrices = SqlCondition::anyOf({ SqlCondition::between("price", 1.00, 2.00),
+                                                     SqlCondition("name", "CONTAINS", "cookie") });
+    std::cout << "Same shape as with other prices: " << (otherPrices.getShape() == drinksOrCookies.getShape()) << std::endl;
+    std::cout << "Same key as with other prices: " << (otherPrices.getKey() == drinksOrCookies.getKey()) << std::endl;
+    std::cout << "Key: " << drinksOrCookies.getKey() << std::endl << std::endl;
+
+    // --- Large IN lists ---
+
+    // Lists longer than SqlCondition's threshold are bound as one JSON array, so they are not limited by the number of parameters.
+    // The order details are rolled back.
+    {
+        Transaction transaction;
+        std::vector<OrderDetail> details;
+        std::vector<int> orderNumbers;
+        for (int i = 1; i <= 5000; i++) {
+            details.push_back(OrderDetail(0, i, "Coffee", 1));
+            orderNumbers.push_back(i);
+        }
+        db.insertMany(details);
+        std::cout << "Details of 5000 orders, read with one statement: ";
+        std::cout << db.count(OrderDetail(), { SqlCondition("orderNumber", "IN", orderNumbers) }) << std::endl;
+        transaction.rollback();
+    }
+
+    std::vector<double> manyPrices;
+    std::vector<std::string> manyNames;
+    for (int i = 0; i < 100; i++) {
+        manyPrices.push_back(2.29 + i);
+        manyNames.push_back("Item \"" + std::to_string(i) + "\"");
+    }
+    manyNames.push_back("Latte");
+    std::cout << "Items that cost one of 100 prices from $2.29: ";
+    std::cout << db.count(MenuItem(), { SqlCondition("price", "IN", manyPrices) }) << std::endl;
+    std::cout << "Items with one of 101 names: " << db.count(MenuItem(), { SqlCondition("name", "IN", manyNames) }) << std::endl;
+    std::cout << std::endl;
+
+    // --- Concurrent SELECT from database ---
+
+    // Each thread checks its own connection out of the pool, so the reads run in parallel.
+    std::vector<std::thread> threads;
+    std::vector<int> rowsRead(4, 0);
+    for (int t = 0; t < 4; t++)
+    {
+        threads.push_back(std::thread([&db, &rowsRead, t] {
+            for (int i = 0; i < 100; i++)
+            {
+                rowsRead[t] += db.selectWhere(MenuItem()).size();
+            }
+        }));
+    }
+    for (int t = 0; t < 4; t++)
+    {
+        threads[t].join();
+    }
+    std::cout << "Rows read by 4 threads doing 100 selects each: " << rowsRead[0] + rowsRead[1] + rowsRead[2] + rowsRead[3];
+    std::cout << std::endl << std::endl;
+
     // --- UPDATE database ---
 
     m6.setPrice(69.99);
@@ -117,5 +233,88 @@ int main(int argc, const char *argv[])
     menu = db.selectWhere(MenuItem());
     printMenu(menu, "Full menu after everything was deleted:");
 
+    // --- Transactions ---
+
+    db.beginTransaction();
+    db.insert(m1);
+    db.rollback();
+    menu = db.selectWhere(MenuItem());
+    printMenu(menu, "Full menu after Coffee was inserted in a transaction that was rolled back:");
+
+    {
+        Transaction outer;
+        db.insert(m1);
+        {
+            // Nested transactions are savepoints, which can be rolled back without ending the outer transaction.
+            Transaction inner;
+            db.insert(m2);
+            inner.rollback();
+        }
+        outer.commit();
+    }
+    menu = db.selectWhere(MenuItem());
+    printMenu(menu, "Full menu after Coffee was committed and Latte was rolled back in a nested transaction:");
+
+    try
+    {
+        Transaction transaction;
+        db.insert(m3);
+        // Coffee is already in the table, so this violates the primary key and throws.
+        db.insert(m1);
+        transaction.commit();
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cout << "Exception thrown in transaction: " << e.what() << std::endl << std::endl;
+    }
+    menu = db.selectWhere(MenuItem());
+    printMenu(menu, "Full menu after Cappuccino was inserted in a transaction that threw an exception:");
+
+    db.destroyWhere(MenuItem(), {});
+
+    // --- Bulk INSERT ---
+
+    db.insertMany(std::vector<MenuItem>({ m1, m2, m3 }));
+    menu = db.selectWhere(MenuItem(), {}, "name");
+    printMenu(menu, "Full menu after Coffee, Latte, and Cappuccino were inserted together, sorted by name:");
+
+    // --- Menu cache ---
+
+    // The cached menu is only read again when it is reloaded.
+    std::shared_ptr<const MenuSnapshot> cachedMenu = MenuCache::getInstance().get();
+    db.insert(m4);
+    double cookiePrice = 0;
+    std::cout << "Cached menu version " << cachedMenu->getVersion() << " has " << cachedMenu->getItems().size() << " items, ";
+    std::cout << "Cookie " << (cachedMenu->getPrice("Cookie", cookiePrice) ? "found" : "not found") << std::endl;
+    cachedMenu = MenuCache::getInstance().reload();
+    cachedMenu->getPrice("Cookie", cookiePrice);
+    std::cout << "Reloaded menu version " << cachedMenu->getVersion() << " has " << cachedMenu->getItems().size() << " items, ";
+    std::cout << "Cookie $" << cookiePrice << ", Latte at index " << cachedMenu->find("Latte") << std::endl << std::endl;
+
+    db.destroyWhere(MenuItem(), {});
+    MenuCache::getInstance().reload();
+
+    // --- Columns listed by name ---
+
+    // The model's columns are bound and read by name, so they do not need to be in the same order as in the SQL table.
+    db.insert(MenuItemIngredient("Latte", 3, 2));
+    std::vector<MenuItemIngredient> ingredients = db.selectWhere(MenuItemIngredient(), {SqlCondition("menuItemName", "=", "Latte")});
+    std::cout << "Ingredients of Latte:" << std::endl;
+    for (int i = 0; i < ingredients.size(); i++) {
+        std::cout << "  inventory item " << ingredients[i].getInventoryItemID() << " x" << ingredients[i].getQuantity() << std::endl;
+    }
+    std::cout << std::endl;
+
+    db.destroyWhere(MenuItemIngredient(), {});
+
+    // --- Statement cache ---
+
+    // The same queries were generated many times above, so most of them should have reused a cached statement.
+    StatementCache::Stats stats = db.getStatementCacheStats();
+    std::cout << "Statement cache:" << std::endl;
+    std::cout << "  hits: " << stats.hits << ", misses: " << stats.misses;
+    std::cout << ", size: " << stats.size << "/" << stats.capacity << std::endl;
+    std::cout << std::endl;
+
     return 0;
 }
@@ -13,10 +13,12 @@
 #include <iostream>
 
 #include "Authenticator.hpp"
+#include "DBConfig.hpp"
 #include "DBHelper.hpp"
 #include "MenuItem.hpp"
 #include "OrderMaster.hpp"
 #include "OrderDetail.hpp"
+#include "Transaction.hpp"
 
 std::string formatDateTime(std::tm time)
 {
@@ -76,11 +78,8 @@ std::vector<MenuItem> generateMenuItems()
         MenuItem("Brunc.h Special", 16.99, "Scrambled eggs, breakfast sausage, home fries, and two pieces of toast. Made fresh when you order."),
     };
     
-    for (int i = 0; i < menu.size(); ++i)
-    {
-        db.insert(menu[i]);
-        printProgress(i / (menu.size() - 1));
-    }
+    db.insertMany(menu);
+    printProgress(1);
     
     std::cout << std::endl << "Complete!" << std::endl;
     
@@ -103,6 +102,9 @@ void generatePastOrders(std::tm *localTm, std::mt19937 &rng, std::vector<MenuIte
     // Weights for menu items in the order they are inserted.
     std::vector<int> weights = { 4, 9, 7, 3, 2, 5, 4, 3 };
     
+    // Everything is generated in one transaction, so it is committed to disk once instead of once per row.
+    Transaction transaction;
+    
     int daysToGenerate = 367;
     for (int daysAgo = 1; daysAgo <= daysToGenerate; ++daysAgo)
     {
@@ -112,19 +114,23 @@ void generatePastOrders(std::tm *localTm, std::mt19937 &rng, std::vector<MenuIte
         
         std::uniform_int_distribution<int> distr(2, 5 + (daysSinceStart / 20));
         
+        std::vector<OrderDetail> details;
         for (int iMenu = 0; iMenu < menu.size(); ++iMenu)
         {
             for (int i = 0; i < weights[iMenu]; ++i)
             {
                 int quantity = (daysSinceStart / 20) + distr(rng);
                 
-                db.insert(OrderDetail(0, orderNumber, menu[iMenu].getName(), quantity));
+                details.push_back(OrderDetail(0, orderNumber, menu[iMenu].getName(), quantity));
             }
         }
+        db.insertMany(details);
         
         printProgress((double)daysAgo / 367);
     }
     
+    transaction.commit();
+    
     std::cout << std::endl << "Complete!" << std::endl;
 }
 
@@ -196,9 +202,13 @@ void generateAdmin()
 
 /**
  * @brief Runs the data generation functions.
+ *
+ * Accepts the "--db-*" options of DBConfig::fromArgs(), e.g. "--db-path=/tmp/scratch.db" to fill a scratch database.
  */
-int main(int argc, const char *argv[])
+int main(int argc, char *argv[])
 {
+    DBHelper::configure(DBConfig::fromArgs(argc, argv));
+    
     // RNG
     std::mt19937 rng;
     rng.seed((int)time(0));
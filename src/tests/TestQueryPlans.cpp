@@ -0,0 +1,114 @@
+//
+//  TestQueryPlans.cpp
+//
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Admin.hpp"
+#include "DBHelper.hpp"
+#include "MenuItemIngredient.hpp"
+#include "OrderDetail.hpp"
+#include "OrderMaster.hpp"
+#include "SqlPage.hpp"
+#include "vOrderDetail.hpp"
+#include "vOrderSales.hpp"
+
+/**
+ * @brief Prints the query plan of a query, and checks that it does not read a whole table.
+ *
+ * A step "SCAN t" reads every row of table t, which means an index that the query needs is missing. Scanning the rows of a
+ * subquery, which the plan lists as a CO-ROUTINE or MATERIALIZE step first, is allowed, since the subquery has a plan of its own.
+ * So is scanning a virtual table, such as the json_each() that a long IN list is bound as, since it only holds the bound values.
+ *
+ * @param name the name of the query, printed with its plan
+ * @param plan the plan returned by DBHelper::explainWhere()
+ * @param indexOrder if true, the rows must also be read in the order of an index, rather than sorted after being read
+ * @return true if the plan only searches indexes
+ */
+bool checkPlan(const std::string &name, const std::vector<std::string> &plan, bool indexOrder = false)
+{
+    std::set<std::string> subqueries;
+    bool passed = true;
+    std::cout << name << ":" << std::endl;
+    for (std::vector<std::string>::const_iterator it = plan.begin(); it != plan.end(); it++)
+    {
+        std::string step = it->substr(0, it->find(' '));
+        std::string object = it->substr(it->find(' ') + 1);
+        object = object.substr(0, object.find(' '));
+
+        bool slow = false;
+        if (step == "CO-ROUTINE" || step == "MATERIALIZE")
+        {
+            subqueries.insert(object);
+        }
+        else if (step == "SCAN")
+        {
+            slow = object != "CONSTANT" && subqueries.count(object) == 0 && it->find("VIRTUAL TABLE") == std::string::npos;
+        }
+        else if (indexOrder && it->find("USE TEMP B-TREE") != std::string::npos)
+        {
+            slow = true;
+        }
+
+        std::cout << (slow ? "  FAIL " : "       ") << *it << std::endl;
+        passed = passed && !slow;
+    }
+    std::cout << std::endl;
+    return passed;
+}
+
+/**
+ * @brief Checks the query plans of the queries the web pages run most often, as DBHelper generates them.
+ *
+ * The plans do not depend on the data in the database.
+ *
+ * @param argc number of command line args, not used
+ * @param argv command line args, not used
+ * @return 0 if every query uses an index, 1 otherwise
+ */
+int main(int argc, const char *argv[])
+{
+    const DBHelper &db = DBHelper::getInstance();
+    bool passed = true;
+
+    // OrderListPage, counting the open orders.
+    passed &= checkPlan("Open orders",
+                        db.explainWhere(OrderMaster(), { SqlCondition("status", "=", "ordered") }));
+
+    // OrderListPage, loading the next page of open orders. Each page must be read in index order, or every open order is
+    // sorted to read one page.
+    passed &= checkPlan("Page of open orders",
+                        db.explainWhere(OrderMaster(), { SqlCondition("status", "=", "ordered") }, "orderDate, orderNumber",
+                                        SqlPage(20).after("orderDate", "").after("orderNumber", 0)),
+                        true);
+
+    // OrderListPage, expanding the details of an order.
+    passed &= checkPlan("Details of an order",
+                        db.explainWhere(vOrderDetail(), { SqlCondition("orderNumber", "=", 0) }, "menuItemName"));
+
+    // The lines of many orders, bound as one JSON array.
+    passed &= checkPlan("Details of many orders",
+                        db.explainWhere(OrderDetail(), { SqlCondition("orderNumber", "IN", std::vector<int>(100, 0)) }));
+
+    // The line of one menu item in an order.
+    passed &= checkPlan("Detail of a menu item in an order",
+                        db.explainWhere(OrderDetail(), { SqlCondition("orderNumber", "=", 0), SqlCondition("menuItemName", "=", "") }));
+
+    // The menu items that use an inventory item.
+    passed &= checkPlan("Menu items using an inventory item",
+                        db.explainWhere(MenuItemIngredient(), { SqlCondition("inventoryItemID", "=", 0) }));
+
+    // Authenticator, logging in.
+    passed &= checkPlan("Admin by user name",
+                        db.explainWhere(Admin(), { SqlCondition("userName", "=", ""), SqlCondition("password", "=", "") }));
+
+    // SalesCache, reading the sales of the charted days.
+    passed &= checkPlan("Sales of a date range",
+                        db.explainWhere(vOrderSales(), { SqlCondition::between("salesDate", "", "") }));
+
+    std::cout << (passed ? "All queries use an index." : "Some queries do not use an index.") << std::endl;
+    return passed ? 0 : 1;
+}
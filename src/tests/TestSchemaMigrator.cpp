@@ -0,0 +1,174 @@
+//
+//  TestSchemaMigrator.cpp
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "sqlite3.h"
+
+#include "SchemaMigrator.hpp"
+
+/**
+ * @brief Prints the result of a check, with the expected result in brackets.
+ *
+ * @param name what was checked
+ * @param expected the expected result
+ * @param actual the actual result
+ * @return true if they are the same
+ */
+bool check(const std::string &name, long long expected, long long actual)
+{
+    std::cout << name << "(" << expected << "): " << actual << std::endl;
+    return expected == actual;
+}
+
+/**
+ * @brief Counts the rows a query returns.
+ *
+ * @param db the database handle
+ * @param query the select query
+ * @return the number of rows, or -1 if the query failed
+ */
+long long countRows(sqlite3 *db, const std::string &query)
+{
+    sqlite3_stmt *statement = NULL;
+    if (sqlite3_prepare_v2(db, query.c_str(), -1, &statement, NULL) != SQLITE_OK)
+    {
+        return -1;
+    }
+    long long rows = 0;
+    while (sqlite3_step(statement) == SQLITE_ROW)
+    {
+        rows++;
+    }
+    sqlite3_finalize(statement);
+    return rows;
+}
+
+/**
+ * @brief The rows DailySales should hold: the sales of the checked out orders, aggregated the way the migrations fill it.
+ */
+const std::string dailySales = "SELECT DATETIME(DATE(om.orderDate)) AS salesDate, od.menuItemName, SUM(od.quantity), "
+                               "SUM(od.quantity * m.price) "
+                               "FROM OrderDetail AS od "
+                               "INNER JOIN MenuItem AS m ON m.name=od.menuItemName "
+                               "INNER JOIN OrderMaster AS om ON om.orderNumber=od.orderNumber "
+                               "WHERE om.status != 'cart' "
+                               "GROUP BY salesDate,od.menuItemName";
+
+/**
+ * @brief Migrates in-memory databases: a new one, whose DailySales is checked after each kind of change, one created by the old
+ * sql/tables.sql, one with a failing migration, and one newer than this program.
+ *
+ * @param argc number of command line args, not used
+ * @param argv command line args, not used
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(int argc, const char *argv[])
+{
+    SchemaMigrator migrator;
+    SchemaMigrator::ProgressListener quiet = [](const SchemaMigrator::Progress &progress) { };
+    bool passed = true;
+    sqlite3 *db = NULL;
+
+    // --- New database ---
+
+    sqlite3_open(":memory:", &db);
+    int applied = migrator.migrate(db);
+    std::cout << std::endl;
+    passed &= check("Migrations applied to a new database", migrator.getLatestVersion(), applied);
+    passed &= check("Version of a new database", migrator.getLatestVersion(), SchemaMigrator::getVersion(db));
+    passed &= check("Migrations applied again", 0, migrator.migrate(db, quiet));
+    passed &= check("DailySales triggers", 9, countRows(db, "SELECT name FROM sqlite_master WHERE type='trigger';"));
+    std::cout << std::endl;
+
+    // --- DailySales ---
+
+    // Each change is made to the database migrated above, and DailySales is compared with the rows it is filled with.
+    const std::string salesDiff = "SELECT * FROM DailySales EXCEPT " + dailySales + " UNION ALL "
+                                  "SELECT * FROM (" + dailySales + " EXCEPT SELECT * FROM DailySales);";
+    sqlite3_exec(db, "INSERT INTO MenuItem VALUES ('Coffee', 2.5, ''), ('Tea', 1.5, '');"
+                     "INSERT INTO OrderMaster VALUES (1, 'test', '2022-11-29 10:00:00', 'cart', 'session');"
+                     "INSERT INTO OrderMaster VALUES (2, 'test', '2022-11-29 11:00:00', 'cart', 'session');"
+                     "INSERT INTO OrderDetail VALUES (1, 1, 'Coffee', 2), (2, 1, 'Tea', 1), (3, 2, 'Coffee', 1);"
+                     "UPDATE OrderMaster SET status='ordered';", NULL, NULL, NULL);
+    passed &= check("Days and menu items of the checked out orders", 2, countRows(db, "SELECT * FROM DailySales;"));
+    passed &= check("Rows that differ after checking out", 0, countRows(db, salesDiff));
+    sqlite3_exec(db, "UPDATE MenuItem SET price=3.5 WHERE name='Coffee';"
+                     "DELETE FROM OrderDetail WHERE orderDetailID=1;", NULL, NULL, NULL);
+    passed &= check("Coffee sold after a price change and a deleted line", 1,
+                    countRows(db, "SELECT * FROM DailySales WHERE menuItemName='Coffee' AND totalQuantity=1 AND totalRevenue=3.5;"));
+    passed &= check("Rows that differ after a price change", 0, countRows(db, salesDiff));
+    sqlite3_exec(db, "UPDATE OrderDetail SET orderNumber=orderNumber, menuItemName=menuItemName, quantity=quantity;"
+                     "DELETE FROM MenuItem WHERE name='Tea';"
+                     "DELETE FROM OrderDetail WHERE orderDetailID=2;", NULL, NULL, NULL);
+    passed &= check("Rows that differ after removing a menu item", 0, countRows(db, salesDiff));
+    sqlite3_exec(db, "UPDATE OrderMaster SET orderDate='2022-11-30 09:00:00' WHERE orderNumber=2;"
+                     "UPDATE OrderDetail SET quantity=4 WHERE orderDetailID=3;", NULL, NULL, NULL);
+    passed &= check("Rows that differ after moving an order", 0, countRows(db, salesDiff));
+    sqlite3_exec(db, "UPDATE OrderMaster SET status='cart';", NULL, NULL, NULL);
+    passed &= check("Days and menu items after moving the orders back to the cart", 0, countRows(db, "SELECT * FROM DailySales;"));
+    sqlite3_close(db);
+    std::cout << std::endl;
+
+    // --- Database created by the old sql/tables.sql ---
+
+    // Every migration was run by hand, without setting the version.
+    sqlite3_open(":memory:", &db);
+    const std::vector<SchemaMigrator::Migration> &migrations = SchemaMigrator::getSchemaMigrations();
+    for (std::vector<SchemaMigrator::Migration>::const_iterator it = migrations.begin(); it != migrations.end(); it++)
+    {
+        sqlite3_exec(db, it->sql.c_str(), NULL, NULL, NULL);
+    }
+    sqlite3_exec(db, "INSERT INTO MenuItem VALUES ('Coffee', 2.29, '');"
+                     "INSERT INTO OrderMaster VALUES (1, 'test', '2022-11-29 10:00:00', 'ordered', 'session');"
+                     "INSERT INTO OrderDetail VALUES (1, 1, 'Coffee', 2);", NULL, NULL, NULL);
+    passed &= check("Version of a database created by tables.sql", 0, SchemaMigrator::getVersion(db));
+    passed &= check("Migrations applied to it", migrator.getLatestVersion(), migrator.migrate(db, quiet));
+    passed &= check("Orders kept", 1, countRows(db, "SELECT * FROM OrderMaster;"));
+    passed &= check("Sales not counted twice", 2, countRows(db, "SELECT * FROM vOrderSales WHERE totalQuantity=2;"));
+    sqlite3_close(db);
+    std::cout << std::endl;
+
+    // --- Failing migration ---
+
+    SchemaMigrator failing({ { 1, "Create Item", "CREATE TABLE Item (name TEXT);" },
+                             { 2, "Create Price", "CREATE TABLE Price (price REAL); INSERT INTO Missing VALUES (1);" } });
+    sqlite3_open(":memory:", &db);
+    try
+    {
+        failing.migrate(db, quiet);
+        std::cout << "Failing migration threw(1): 0" << std::endl;
+        passed = false;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Failing migration threw(1): 1, " << e.what() << std::endl;
+    }
+    passed &= check("Version after a failing migration", 1, SchemaMigrator::getVersion(db));
+    passed &= check("Tables of the failing migration", -1, countRows(db, "SELECT * FROM Price;"));
+    sqlite3_close(db);
+    std::cout << std::endl;
+
+    // --- Database newer than this program ---
+
+    sqlite3_open(":memory:", &db);
+    sqlite3_exec(db, ("PRAGMA user_version = " + std::to_string(migrator.getLatestVersion() + 1) + ";").c_str(), NULL, NULL, NULL);
+    try
+    {
+        migrator.migrate(db, quiet);
+        std::cout << "Newer database threw(1): 0" << std::endl;
+        passed = false;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Newer database threw(1): 1, " << e.what() << std::endl;
+    }
+    sqlite3_close(db);
+    std::cout << std::endl;
+
+    std::cout << (passed ? "All checks passed." : "Some checks failed.") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+//
+//  TestWriteQueue.cpp
+//
+
+#include <future>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DBHelper.hpp"
+#include "OrderMaster.hpp"
+#include "SqlCondition.hpp"
+#include "WriteQueue.hpp"
+
+/**
+ * @brief Prints the result of a check, with the expected result in brackets.
+ *
+ * @param name what was checked
+ * @param expected the expected result
+ * @param actual the actual result
+ * @return true if they are the same
+ */
+bool check(const std::string &name, long long expected, long long actual)
+{
+    std::cout << name << "(" << expected << "): " << actual << std::endl;
+    return expected == actual;
+}
+
+/**
+ * @brief Adds a write that keeps the writer thread busy until the returned promise is set, so that the writes added in the
+ * meantime are committed in the next batch.
+ *
+ * @param queue the write queue
+ * @return set to let the writer thread go on
+ */
+std::shared_ptr<std::promise<void>> holdWriter(WriteQueue &queue)
+{
+    std::shared_ptr<std::promise<void>> release = std::make_shared<std::promise<void>>();
+    std::shared_future<void> released = release->get_future().share();
+    std::shared_ptr<std::promise<void>> started = std::make_shared<std::promise<void>>();
+    std::future<void> writerStarted = started->get_future();
+    queue.submit<void>([started, released] {
+        started->set_value();
+        released.wait();
+    });
+    writerStarted.wait();
+    return release;
+}
+
+/**
+ * @brief Creates a test order, which belongs to the session "TestWriteQueue".
+ *
+ * @return the order
+ */
+OrderMaster testOrder()
+{
+    return OrderMaster(0, "TestWriteQueue", "2022-11-29 10:00:00", "test", "TestWriteQueue");
+}
+
+/**
+ * @brief Writes orders through the write queue from many threads at once, and checks that they are committed in batches and that
+ * a failing write does not fail the rest of its batch. The orders are deleted afterwards.
+ *
+ * @param argc number of command line args, not used
+ * @param argv command line args, not used
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(int argc, const char *argv[])
+{
+    const DBHelper &db = DBHelper::getInstance();
+    WriteQueue &queue = WriteQueue::getInstance();
+    std::vector<SqlCondition> testOrders = { SqlCondition("sessionID", "=", "TestWriteQueue") };
+    bool passed = true;
+
+    // --- Many sessions ---
+
+    const int numThreads = 8;
+    const int ordersPerThread = 100;
+    std::vector<std::vector<long long>> keys(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++)
+    {
+        threads.push_back(std::thread([&queue, &keys, t] {
+            std::vector<std::future<long long>> futures;
+            for (int i = 0; i < ordersPerThread; i++)
+            {
+                futures.push_back(queue.insert(testOrder()));
+            }
+            for (std::vector<std::future<long long>>::iterator it = futures.begin(); it != futures.end(); it++)
+            {
+                keys[t].push_back(it->get());
+            }
+        }));
+    }
+    for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); it++)
+    {
+        it->join();
+    }
+
+    std::set<long long> uniqueKeys;
+    for (std::vector<std::vector<long long>>::iterator it = keys.begin(); it != keys.end(); it++)
+    {
+        uniqueKeys.insert(it->begin(), it->end());
+    }
+    WriteQueue::Stats stats = queue.getStats();
+    passed &= check("Orders written by 8 threads", numThreads * ordersPerThread, db.count(OrderMaster(), testOrders));
+    passed &= check("Distinct keys returned", numThreads * ordersPerThread, uniqueKeys.size());
+    std::cout << "Batches: " << stats.batches << ", largest: " << stats.largestBatch << std::endl;
+    std::cout << std::endl;
+
+    // --- Group commit ---
+
+    // The writes added while the writer is busy are all committed in the next transaction.
+    std::shared_ptr<std::promise<void>> release = holdWriter(queue);
+    WriteQueue::Stats before = queue.getStats();
+    std::vector<std::future<long long>> futures;
+    for (int i = 0; i < 100; i++)
+    {
+        futures.push_back(queue.insert(testOrder()));
+    }
+    release->set_value();
+    for (std::vector<std::future<long long>>::iterator it = futures.begin(); it != futures.end(); it++)
+    {
+        it->get();
+    }
+    WriteQueue::Stats after = queue.getStats();
+    passed &= check("Transactions for 100 queued writes", 2, after.batches - before.batches);
+    passed &= check("Writes in them", 101, after.writes - before.writes);
+    std::cout << std::endl;
+
+    // --- Failing write ---
+
+    release = holdWriter(queue);
+    std::future<long long> first = queue.insert(testOrder());
+    std::future<void> failing = queue.submit<void>([] {
+        DBHelper::getInstance().insert(testOrder());
+        throw std::runtime_error("Test error.");
+    });
+    std::future<long long> last = queue.insert(testOrder());
+    release->set_value();
+
+    try
+    {
+        failing.get();
+        std::cout << "Failing write threw(1): 0" << std::endl;
+        passed = false;
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Failing write threw(1): 1, " << e.what() << std::endl;
+    }
+    passed &= check("Writes committed with it", 2, (first.get() != 0) + (last.get() != 0));
+    passed &= check("Orders after the failing write", numThreads * ordersPerThread + 102, db.count(OrderMaster(), testOrders));
+    std::cout << std::endl;
+
+    // --- Clean up ---
+
+    queue.submit<void>([testOrders] { DBHelper::getInstance().destroyWhere(OrderMaster(), testOrders); }).get();
+    passed &= check("Orders after deleting them", 0, db.count(OrderMaster(), testOrders));
+    std::cout << std::endl;
+
+    std::cout << (passed ? "All checks passed." : "Some checks failed.") << std::endl;
+    return passed ? 0 : 1;
+}
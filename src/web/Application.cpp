@@ -17,6 +17,7 @@ Application::Application(const Wt::WEnvironment &env) : Wt::WApplication(env)
     internalPathChanged().connect(this, &Application::handleInternalPath);
     
     auth = new Authenticator();
+    cart = new CartState(sessionId());
     
     navbar = root()->addNew<NavbarWidget>();
     body = root()->addNew<HomePage>();
@@ -26,6 +27,7 @@ Application::Application(const Wt::WEnvironment &env) : Wt::WApplication(env)
 
 Application::~Application()
 {
+    delete cart;
     delete auth;
 }
 
@@ -82,6 +84,11 @@ Authenticator * Application::getAuth()
     return auth;
 }
 
+CartState * Application::getCart()
+{
+    return cart;
+}
+
 void Application::reset()
 {
     root()->removeWidget(navbar);
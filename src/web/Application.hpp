@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "Authenticator.hpp"
+#include "CartState.hpp"
 #include "CustomLoadingIndicator.hpp"
 #include "NavbarWidget.hpp"
 #include "HomePage.hpp"
@@ -61,6 +62,13 @@ public:
      * @return Authenticator reference
      */
     Authenticator * getAuth();
+
+    /**
+     * @brief Gets the cart for this session.
+     *
+     * @return CartState pointer
+     */
+    CartState * getCart();
     
     /**
      * @brief Recreates the navbar and redirects to the home page.
@@ -74,6 +82,11 @@ private:
      * @brief The authenticator for this session.
      */
     Authenticator *auth;
+
+    /**
+     * @brief The cart for this session. Deleted with the session, which writes any unsaved changes.
+     */
+    CartState *cart;
     
     /** The navbar widget. */
     NavbarWidget *navbar;
@@ -0,0 +1,159 @@
+//
+//  AsyncDB.cpp
+//
+
+#include "AsyncDB.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include <Wt/WApplication.h>
+#include <Wt/WServer.h>
+
+AsyncDB * AsyncDB::instance = NULL;
+
+std::once_flag AsyncDB::instanceFlag;
+
+AsyncDB::AsyncDB()
+{
+    nextRequestID = 1;
+
+    int numThreads = std::max(4, (int)std::thread::hardware_concurrency());
+    for (int i = 0; i < numThreads; i++)
+    {
+        threads.push_back(std::thread([this] { work(); }));
+    }
+}
+
+AsyncDB & AsyncDB::getInstance()
+{
+    std::call_once(instanceFlag, [] { instance = new AsyncDB(); });
+    return *instance;
+}
+
+void AsyncDB::cancel(int requestID)
+{
+    bool cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = requests.erase(requestID) > 0;
+    }
+
+    // The updates enabled by submit() are disabled here, since the request will not be delivered.
+    if (cancelled)
+    {
+        Wt::WApplication::instance()->enableUpdates(false);
+    }
+}
+
+int AsyncDB::submit(Job job, ErrorListener onError)
+{
+    Wt::WApplication *app = Wt::WApplication::instance();
+    app->enableUpdates(true);
+
+    int requestID;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestID = nextRequestID++;
+        requests[requestID] = { app->sessionId(), onError };
+        queue.push_back(std::make_pair(requestID, job));
+    }
+    jobAdded.notify_one();
+    return requestID;
+}
+
+void AsyncDB::work()
+{
+    while (true)
+    {
+        int requestID;
+        Job job;
+        std::string sessionID;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAdded.wait(lock, [this] { return !queue.empty(); });
+            requestID = queue.front().first;
+            job = std::move(queue.front().second);
+            queue.pop_front();
+
+            // A request that was cancelled before it started is not run, since no one is waiting for it.
+            std::map<int, Request>::iterator request = requests.find(requestID);
+            if (request == requests.end())
+            {
+                continue;
+            }
+            sessionID = request->second.sessionID;
+        }
+
+        Completion completion;
+        std::exception_ptr error;
+        try
+        {
+            completion = job();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+
+        Wt::WServer::instance()->post(sessionID, [this, requestID, completion, error] { deliver(requestID, completion, error); });
+    }
+}
+
+void AsyncDB::deliver(int requestID, const Completion &completion, std::exception_ptr error)
+{
+    // The request is looked up again, because the page that started it may have been destroyed since the result was posted.
+    // Cancelling happens in this same session, so it cannot happen while the listeners run.
+    ErrorListener onError;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<int, Request>::iterator request = requests.find(requestID);
+        if (request == requests.end())
+        {
+            return;
+        }
+        onError = request->second.onError;
+        requests.erase(request);
+    }
+
+    // Pushes the changes and disables the updates enabled by submit() even if a listener throws.
+    struct UpdateGuard
+    {
+        Wt::WApplication *app;
+
+        ~UpdateGuard()
+        {
+            app->triggerUpdate();
+            app->enableUpdates(false);
+        }
+    } updateGuard = { Wt::WApplication::instance() };
+
+    ErrorListener report = [&onError](const std::exception &e) {
+        if (onError)
+        {
+            onError(e);
+        }
+        else
+        {
+            std::cerr << "Error in AsyncDB query. " << e.what() << std::endl;
+        }
+    };
+
+    try
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        completion();
+    }
+    catch (const std::exception &e)
+    {
+        report(e);
+    }
+    catch (...)
+    {
+        report(std::runtime_error("The query or its listener threw an exception that is not a std::exception."));
+    }
+}
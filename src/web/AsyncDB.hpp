@@ -0,0 +1,190 @@
+//
+//  AsyncDB.hpp
+//
+
+#ifndef AsyncDB_hpp
+#define AsyncDB_hpp
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide pool of threads that run database queries for the sessions, so that a slow query does not hold a session.
+ *
+ * A session starts a query with run(), which returns at once. The query runs on one of the pool's threads, and its result is passed
+ * to a listener called in that session through Wt::WServer::post(), so the listener can update the widgets directly. The session
+ * is pushed the changes afterwards, run() enables updates for it until then.
+ *
+ * A page that starts a query must cancel it when the page is destroyed, since the listener usually uses the page.
+ *
+ * Thread-safe.
+ */
+class AsyncDB
+{
+public:
+    /**
+     * @brief Called in the session if a query or its result listener throws, with the exception, or with a std::runtime_error if
+     * what was thrown is not a std::exception.
+     */
+    typedef std::function<void(const std::exception &)> ErrorListener;
+
+    /**
+     * @brief Gets the singleton instance of this class.
+     *
+     * @return singleton instance of AsyncDB
+     */
+    static AsyncDB & getInstance();
+
+    /**
+     * @brief Runs a query on the pool, and calls a listener with its result in the current session.
+     *
+     * Must be called from within a session. The type of the result must be given, e.g. run<int>(...), since it cannot be deduced
+     * from a lambda.
+     *
+     * @param query called on a thread of the pool, so it must only use the database and its own copies of the data it needs
+     * @param onResult called in the current session with the result of the query
+     * @param onError called in the current session if the query or onResult throws. If empty, the error is printed to the standard
+     * error.
+     * @return the request ID, to be passed to cancel()
+     */
+    template<class T>
+    int run(std::function<T()> query, std::function<void(T &)> onResult, ErrorListener onError = ErrorListener())
+    {
+        // The query runs on the pool, but the listener only in the session, with the result the query gave it.
+        return submit([query, onResult]() -> Completion {
+            std::shared_ptr<T> result = std::make_shared<T>(query());
+            return [onResult, result] { onResult(*result); };
+        }, onError);
+    }
+
+    /**
+     * @brief Stops a query from calling its listeners. The query is not run, if it has not started yet.
+     *
+     * Must be called from within the session that started the query, before anything the listeners use is destroyed. Does
+     * nothing if the listeners have already been called.
+     *
+     * @param requestID the ID returned by run()
+     */
+    void cancel(int requestID);
+
+private:
+    /**
+     * @brief Calls the listener of a query in the session. Returned by a job once the query has run.
+     */
+    typedef std::function<void()> Completion;
+
+    /**
+     * @brief Runs a query on the pool, and returns its completion.
+     */
+    typedef std::function<Completion()> Job;
+
+    /**
+     * @brief A query that was started and whose listeners have not been called yet.
+     */
+    struct Request
+    {
+        /** The Wt session ID of the session that started the query. */
+        std::string sessionID;
+
+        /** Called in the session if the query or its result listener throws. */
+        ErrorListener onError;
+    };
+
+    /**
+     * @brief Singleton instance of AsyncDB.
+     */
+    static AsyncDB *instance;
+
+    /**
+     * @brief Ensures the singleton instance is only created once.
+     */
+    static std::once_flag instanceFlag;
+
+    /**
+     * @brief Held while requests and queue are used.
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief Notified when a job is added to queue.
+     */
+    std::condition_variable jobAdded;
+
+    /**
+     * @brief The requests that have not been completed or cancelled, by ID.
+     */
+    std::map<int, Request> requests;
+
+    /**
+     * @brief The jobs that have not started yet, in the order they were submitted, with their request IDs.
+     */
+    std::deque<std::pair<int, Job>> queue;
+
+    /**
+     * @brief The threads of the pool.
+     */
+    std::vector<std::thread> threads;
+
+    /**
+     * @brief The ID of the next request.
+     */
+    int nextRequestID;
+
+    /**
+     * @brief Constructor.
+     *
+     * Starts one thread for each core, and at least 4, the same as the number of database connections by default, so that the
+     * threads do not wait for connections.
+     */
+    AsyncDB();
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented to prevent copying of singleton instance.
+     */
+    AsyncDB(const AsyncDB &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented to prevent assignment of singleton instance.
+     */
+    AsyncDB& operator=(const AsyncDB &other);
+
+    /**
+     * @brief Adds a job to the queue for the current session, and enables updates for the session until it is completed.
+     *
+     * @param job runs the query
+     * @param onError called in the current session if the job or its completion throws
+     * @return the request ID
+     */
+    int submit(Job job, ErrorListener onError);
+
+    /**
+     * @brief Runs the jobs in the queue, waiting for more when it is empty. Run by each thread of the pool.
+     */
+    void work();
+
+    /**
+     * @brief Calls the completion or the error listener of a request, if it was not cancelled, then pushes the changes to the
+     * browser.
+     *
+     * Runs in the session that started the query.
+     *
+     * @param requestID the request ID
+     * @param completion the completion returned by the job, or empty if the job threw
+     * @param error the exception thrown by the job, or empty
+     */
+    void deliver(int requestID, const Completion &completion, std::exception_ptr error);
+};
+
+#endif /* AsyncDB_hpp */
@@ -17,7 +17,7 @@ bool Authenticator::CreateNewAdmin(std::string username, std::string password) {
     if (password.length()<minChars){
         return false;
     }
-    if (!db.selectWhere(Admin(), {SqlCondition("username", "=", username)}).empty())
+    if (db.exists(Admin(), {SqlCondition("username", "=", username)}))
     {
         return false;
     }
@@ -6,105 +6,77 @@
 #include "CartPage.hpp"
 
 CartPage::CartPage() {
-    std::string sessionID = Wt::WApplication::instance()->sessionId();
+    CartState *cart = ((Application *)Application::instance())->getCart();
+    std::shared_ptr<const MenuSnapshot> menu = MenuCache::getInstance().get();
     addStyleClass("list");
 
-    std::vector<SqlCondition>
-        conditions = {SqlCondition("sessionID", "=", sessionID)};
-    conditions.push_back(SqlCondition("status", "=", "cart"));
-    std::vector<OrderMaster> orderMasters = DBHelper::getInstance().selectWhere(OrderMaster(), conditions);
-    if (orderMasters.size() == 0) {
+    // The page is rendered from the session's cart, and its buttons only change the cart. The cart writes itself to the
+    // database behind the clicks.
+    if (cart->isEmpty()) {
         addWidget(std::make_unique<Wt::WText>("No items in cart"));
         return;
     }
 
-    OrderMaster currOrder = orderMasters[0];
-    conditions = {SqlCondition("orderNumber", "=", currOrder.getOrderNumber())};
-    std::vector<OrderDetail> orderDetails = DBHelper::getInstance().selectWhere(OrderDetail(), conditions);
-
     Wt::WContainerWidget *page = addWidget(std::make_unique<Wt::WContainerWidget>());
 
     // Add checkout widget
     cartTotal = page->addWidget(std::make_unique<CartTotal>(0));
     Wt::WPushButton *checkoutbtn = cartTotal->getCheckoutPtr();
-    auto checkout = [this, sessionID] {
-        std::vector<SqlCondition>
-            conditions = {SqlCondition("sessionID", "=", sessionID)};
-        conditions.push_back(SqlCondition("status", "=", "cart"));
-        std::vector<OrderMaster> orderMasters = DBHelper::getInstance().selectWhere(OrderMaster(), conditions);
-        if (orderMasters.size() == 0) {
+    auto checkout = [this, cart] {
+        OrderMaster order;
+        if (!cart->checkout(this->cartTotal->getName(), order)) {
             return;
-        } else {
-            OrderMaster currOrder = orderMasters[0];
-            currOrder.setStatus("ordered");
-            currOrder.setOrderedBy(this->cartTotal->getName());
-            DBHelper::getInstance().update(currOrder);
         }
+        // Not charted until tomorrow, since the sales cache only covers days up to yesterday.
+        OrderEventBus::getInstance().publish({OrderEvent::Ordered, order});
         Wt::WApplication::instance()->setInternalPath("/orders", true);
     };
     checkoutbtn->clicked().connect(checkout);
 
-    for (std::vector<OrderDetail>::iterator it = orderDetails.begin(); it != orderDetails.end(); it++) {
-        std::string itemName = it->getMenuItemName();
-        int orderID = it->getOrderDetailID();
-        int quantity = it->getQuantity();
-        conditions = {SqlCondition("name", "=", itemName)};
-        double itemPrice = DBHelper::getInstance().selectWhere(MenuItem(), conditions)[0].getPrice();
-        double totalPrice = itemPrice * quantity;
+    const std::vector<CartState::Line> &lines = cart->getLines();
+    for (std::vector<CartState::Line>::const_iterator it = lines.begin(); it != lines.end(); it++) {
+        std::string itemName = it->menuItemName;
+        int quantity = it->quantity;
+        // An item that has been taken off the menu is shown without a price.
+        double itemPrice = 0.0;
+        menu->getPrice(itemName, itemPrice);
 
-        cartTotal->addToTotal(totalPrice);
+        cartTotal->addToTotal(itemPrice * quantity);
 
         CartWidget *cartWidget = page->addWidget(std::make_unique<CartWidget>(itemName, itemPrice, quantity));
 
-        auto addQuantity = [this, cartWidget, orderID] {
+        auto addQuantity = [this, cart, cartWidget, itemName] {
             cartWidget->updateQuantity(cartWidget->getQuantity() + 1);
             cartWidget->updateTotal();
 
             getCartTotalPtr()->addToTotal(cartWidget->getPrice());
 
-            std::vector<SqlCondition> conditions = {SqlCondition("orderDetailID", "=", orderID)};
-            std::vector<OrderDetail> orderDetails = DBHelper::getInstance().selectWhere(OrderDetail(), conditions);
-            OrderDetail orderDetail = orderDetails[0];
-            orderDetail.setQuantity(orderDetail.getQuantity() + 1);
-            DBHelper::getInstance().update(orderDetail);
+            cart->setQuantity(itemName, cartWidget->getQuantity());
         };
 
-        auto subtractQuantity = [this, cartWidget, orderID] {
-            std::vector<SqlCondition> conditions = {SqlCondition("orderDetailID", "=", orderID)};
-            std::vector<OrderDetail> orderDetails = DBHelper::getInstance().selectWhere(OrderDetail(), conditions);
-            OrderDetail orderDetail = orderDetails[0];
-
+        auto subtractQuantity = [this, cart, cartWidget, itemName] {
             if (cartWidget->getQuantity() > 1) {
                 cartWidget->updateQuantity(cartWidget->getQuantity() - 1);
                 cartWidget->updateTotal();
 
                 getCartTotalPtr()->subFromTotal(cartWidget->getPrice());
 
-                orderDetail.setQuantity(orderDetail.getQuantity() - 1);
-                DBHelper::getInstance().update(orderDetail);
+                cart->setQuantity(itemName, cartWidget->getQuantity());
             } else {
                 cartWidget->removeFromParent();
-                DBHelper::getInstance().destroy(orderDetail);
-                if (orderDetails.size() == 1) {
-                    std::vector<SqlCondition> conditions = {SqlCondition("orderNumber", "=", orderDetail.getOrderNumber())};
-                    std::vector<OrderMaster> orderMasters = DBHelper::getInstance().selectWhere(OrderMaster(), conditions);
-                    OrderMaster orderMaster = orderMasters[0];
-                    DBHelper::getInstance().destroy(orderMaster);
-
+                cart->removeItem(itemName);
+                if (cart->isEmpty()) {
                     Wt::WApplication::instance()->setInternalPath("/menu", true);
                 }
             }
         };
 
-        auto removeItem = [this, cartWidget, orderID] {
+        auto removeItem = [this, cart, cartWidget, itemName] {
             CartTotal *cartTotal = getCartTotalPtr();
             cartTotal->subFromTotal(cartWidget->getTotal());
             cartWidget->removeFromParent();
 
-            std::vector<SqlCondition> conditions = {SqlCondition("orderDetailID", "=", orderID)};
-            std::vector<OrderDetail> orderDetails = DBHelper::getInstance().selectWhere(OrderDetail(), conditions);
-            OrderDetail orderDetail = orderDetails[0];
-            DBHelper::getInstance().destroy(orderDetail);
+            cart->removeItem(itemName);
         };
 
         cartWidget->getAddPtr()->clicked().connect(addQuantity);
@@ -12,13 +12,12 @@
 
 #include <string>
 
+#include "Application.hpp"
+#include "CartState.hpp"
 #include "CartWidget.hpp"
-#include "DBHelper.hpp"
-#include "MenuItem.hpp"
-#include "Model.hpp"
-#include "OrderDetail.hpp"
+#include "MenuCache.hpp"
+#include "OrderEventBus.hpp"
 #include "OrderMaster.hpp"
-#include "SqlCondition.hpp"
 
 class CartPage : public Wt::WContainerWidget {
    public:
@@ -0,0 +1,253 @@
+//
+//  CartState.cpp
+//
+
+#include "CartState.hpp"
+
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <iostream>
+
+#include "DBHelper.hpp"
+#include "OrderDetail.hpp"
+#include "SqlCondition.hpp"
+#include "WriteQueue.hpp"
+
+const int CartState::FLUSH_DELAY = 2000;
+
+CartState::CartState(const std::string &sessionID)
+{
+    this->sessionID = sessionID;
+    orderNumber = 0;
+    dirty = false;
+
+    flushTimer = std::make_unique<Wt::WTimer>();
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(std::chrono::milliseconds(FLUSH_DELAY));
+    flushTimer->timeout().connect([this] {
+        try
+        {
+            flush();
+        }
+        catch (const std::exception &e)
+        {
+            // The changes are kept, so the next change or checkout tries again.
+            std::cerr << "Error in CartState: could not write the cart. " << e.what() << std::endl;
+        }
+    });
+}
+
+CartState::~CartState()
+{
+    // Removes every line, as removeItem() does, so that write() deletes their rows and then the cart's order.
+    for (std::vector<Line>::iterator it = lines.begin(); it != lines.end(); it++)
+    {
+        if (it->orderDetailID != 0)
+        {
+            removedDetailIDs.push_back(it->orderDetailID);
+        }
+    }
+    lines.clear();
+    dirty = orderNumber != 0;
+
+    try
+    {
+        flush();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error in CartState::~CartState(): could not delete the cart. " << e.what() << std::endl;
+    }
+}
+
+const std::vector<CartState::Line> & CartState::getLines() const
+{
+    return lines;
+}
+
+bool CartState::isEmpty() const
+{
+    return lines.empty();
+}
+
+void CartState::addItem(const std::string &menuItemName)
+{
+    std::vector<Line>::iterator line = findLine(menuItemName);
+    if (line == lines.end())
+    {
+        Line newLine;
+        newLine.menuItemName = menuItemName;
+        newLine.quantity = 1;
+        newLine.dirty = true;
+        lines.push_back(newLine);
+    }
+    else
+    {
+        line->quantity++;
+        line->dirty = true;
+    }
+    changed();
+}
+
+void CartState::setQuantity(const std::string &menuItemName, int quantity)
+{
+    if (quantity < 1)
+    {
+        removeItem(menuItemName);
+        return;
+    }
+
+    std::vector<Line>::iterator line = findLine(menuItemName);
+    if (line == lines.end() || line->quantity == quantity)
+    {
+        return;
+    }
+    line->quantity = quantity;
+    line->dirty = true;
+    changed();
+}
+
+void CartState::removeItem(const std::string &menuItemName)
+{
+    std::vector<Line>::iterator line = findLine(menuItemName);
+    if (line == lines.end())
+    {
+        return;
+    }
+    if (line->orderDetailID != 0)
+    {
+        removedDetailIDs.push_back(line->orderDetailID);
+    }
+    lines.erase(line);
+    changed();
+}
+
+bool CartState::checkout(const std::string &orderedBy, OrderMaster &order)
+{
+    if (lines.empty())
+    {
+        return false;
+    }
+    flushTimer->stop();
+
+    // Restored if the transaction is rolled back, so the rows are written again by the next try.
+    std::vector<Line> savedLines = lines;
+    int savedOrderNumber = orderNumber;
+    try
+    {
+        // Committed together with the writes of other sessions. The write is atomic, and this session waits for it, so the
+        // cart is not used by two threads at once.
+        WriteQueue::getInstance().submit<void>([this, &orderedBy, &order] {
+            write();
+            // The order is dated when it is placed, not when its cart was created.
+            order = OrderMaster(orderNumber, orderedBy, currentTime(), "ordered", sessionID);
+            DBHelper::getInstance().updateWhere(order, { SqlCondition("orderNumber", "=", orderNumber) },
+                                                { "orderedBy", "orderDate", "status" });
+        }).get();
+    }
+    catch (...)
+    {
+        lines = savedLines;
+        orderNumber = savedOrderNumber;
+        throw;
+    }
+
+    lines.clear();
+    removedDetailIDs.clear();
+    orderNumber = 0;
+    dirty = false;
+    return true;
+}
+
+void CartState::flush()
+{
+    flushTimer->stop();
+    if (!dirty)
+    {
+        return;
+    }
+
+    std::vector<Line> savedLines = lines;
+    int savedOrderNumber = orderNumber;
+    try
+    {
+        WriteQueue::getInstance().submit<void>([this] { write(); }).get();
+    }
+    catch (...)
+    {
+        lines = savedLines;
+        orderNumber = savedOrderNumber;
+        throw;
+    }
+
+    removedDetailIDs.clear();
+    dirty = false;
+}
+
+std::vector<CartState::Line>::iterator CartState::findLine(const std::string &menuItemName)
+{
+    for (std::vector<Line>::iterator it = lines.begin(); it != lines.end(); it++)
+    {
+        if (it->menuItemName == menuItemName)
+        {
+            return it;
+        }
+    }
+    return lines.end();
+}
+
+void CartState::changed()
+{
+    dirty = true;
+    flushTimer->stop();
+    flushTimer->start();
+}
+
+void CartState::write()
+{
+    const DBHelper &db = DBHelper::getInstance();
+
+    for (std::vector<int>::iterator it = removedDetailIDs.begin(); it != removedDetailIDs.end(); it++)
+    {
+        db.destroy(OrderDetail(*it));
+    }
+
+    // An emptied cart is removed rather than kept as an order without details.
+    if (lines.empty())
+    {
+        if (orderNumber != 0)
+        {
+            db.destroy(OrderMaster(orderNumber));
+            orderNumber = 0;
+        }
+        return;
+    }
+
+    if (orderNumber == 0)
+    {
+        orderNumber = (int)db.insert(OrderMaster(0, "test", currentTime(), "cart", sessionID));
+    }
+
+    for (std::vector<Line>::iterator it = lines.begin(); it != lines.end(); it++)
+    {
+        if (it->orderDetailID == 0)
+        {
+            it->orderDetailID = (int)db.insert(OrderDetail(0, orderNumber, it->menuItemName, it->quantity));
+        }
+        else if (it->dirty)
+        {
+            db.update(OrderDetail(it->orderDetailID, orderNumber, it->menuItemName, it->quantity));
+        }
+        it->dirty = false;
+    }
+}
+
+std::string CartState::currentTime()
+{
+    time_t now = time(0);
+    std::tm *ltm = localtime(&now);
+    char time_str[20];
+    std::strftime(time_str, 20, "%Y-%m-%d %H:%M:%S", ltm);
+    return std::string(time_str);
+}
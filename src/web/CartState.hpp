@@ -0,0 +1,202 @@
+//
+//  CartState.hpp
+//
+
+#ifndef CartState_hpp
+#define CartState_hpp
+
+#include <Wt/WTimer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "OrderMaster.hpp"
+
+/**
+ * @brief The cart of one session, held in memory and written to the database behind the user's clicks.
+ *
+ * Adding, removing, and changing the quantity of items only changes the lines in memory, so the menu and cart pages never wait
+ * on the database. The changes are written to OrderMaster and OrderDetail in one transaction by flush(), which is called:
+ *  - FLUSH_DELAY milliseconds after the last change,
+ *  - at checkout, in the same transaction that marks the order as ordered,
+ *  - when the session ends and the Application destroys its cart, which is then deleted.
+ *
+ * The transactions are writes of WriteQueue, so they are committed together with the writes of other sessions, and the session
+ * waits for them.
+ *
+ * Crash recovery: only checked out orders must survive a crash, and checkout() always writes synchronously. A cart that was not
+ * checked out is discarded when its session ends, since Wt session IDs are never reused, so no later session could load it. Its
+ * rows are deleted by the destructor, or, after a crash, left with status 'cart', so they are never counted as sales, until
+ * DBHelper deletes stale carts the next time a program opens the database.
+ *
+ * Prices are not kept, since they can change while an item is in the cart. They are looked up in MenuCache when shown.
+ *
+ * Belongs to one session, so it is not thread-safe.
+ */
+class CartState
+{
+public:
+    /**
+     * @brief One menu item in the cart.
+     */
+    struct Line
+    {
+        /** The OrderDetail row of this line, 0 if it has not been written yet. */
+        int orderDetailID = 0;
+
+        /** The name of the menu item. */
+        std::string menuItemName;
+
+        /** The number of items. */
+        int quantity = 0;
+
+        /** True if the quantity has changed since the line was last written. */
+        bool dirty = false;
+    };
+
+    /**
+     * @brief Milliseconds between the last change and the cart being written to the database.
+     */
+    static const int FLUSH_DELAY;
+
+    /**
+     * @brief Constructor.
+     *
+     * Starts with an empty cart, which is only written to the database once it changes.
+     * Must be called while a Wt::WApplication is active, which owns the flush timer's events.
+     *
+     * @param sessionID the Wt session ID
+     */
+    CartState(const std::string &sessionID);
+
+    /**
+     * @brief Destructor.
+     *
+     * Deletes the cart's rows, since the session has ended without checking out. Errors are printed rather than thrown.
+     */
+    ~CartState();
+
+    /**
+     * @brief Gets the lines of the cart, in the order they were added.
+     *
+     * @return vector of lines
+     */
+    const std::vector<Line> & getLines() const;
+
+    /**
+     * @brief Checks if the cart has no lines.
+     *
+     * @return true if the cart is empty
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Adds one of a menu item, creating its line if it is not in the cart yet.
+     *
+     * @param menuItemName the name of the menu item
+     */
+    void addItem(const std::string &menuItemName);
+
+    /**
+     * @brief Sets the quantity of a menu item that is in the cart. A quantity less than 1 removes the line.
+     *
+     * Does nothing if the menu item is not in the cart.
+     *
+     * @param menuItemName the name of the menu item
+     * @param quantity the new quantity
+     */
+    void setQuantity(const std::string &menuItemName, int quantity);
+
+    /**
+     * @brief Removes a menu item from the cart.
+     *
+     * Does nothing if the menu item is not in the cart.
+     *
+     * @param menuItemName the name of the menu item
+     */
+    void removeItem(const std::string &menuItemName);
+
+    /**
+     * @brief Writes the cart to the database and marks it as ordered, in one transaction, then empties the cart.
+     *
+     * Does nothing if the cart is empty. Throws a runtime exception if the database could not be written, in which case the
+     * cart is left unchanged.
+     *
+     * @param orderedBy the name the order is for
+     * @param order set to the order that was placed
+     * @return true if an order was placed
+     */
+    bool checkout(const std::string &orderedBy, OrderMaster &order);
+
+    /**
+     * @brief Writes any changes that have not been written yet to the database, in one transaction.
+     *
+     * Throws a runtime exception if the database could not be written, in which case the changes are kept to be written again.
+     */
+    void flush();
+
+private:
+    /**
+     * @brief The Wt session ID the cart belongs to.
+     */
+    std::string sessionID;
+
+    /**
+     * @brief The OrderMaster row of the cart, 0 if it has not been written yet.
+     */
+    int orderNumber;
+
+    /**
+     * @brief The lines of the cart.
+     */
+    std::vector<Line> lines;
+
+    /**
+     * @brief OrderDetail rows of removed lines that are still to be deleted.
+     */
+    std::vector<int> removedDetailIDs;
+
+    /**
+     * @brief True if there are changes that have not been written yet.
+     */
+    bool dirty;
+
+    /**
+     * @brief Calls flush() FLUSH_DELAY milliseconds after the last change.
+     */
+    std::unique_ptr<Wt::WTimer> flushTimer;
+
+    /**
+     * @brief Finds the line of a menu item.
+     *
+     * @param menuItemName the name of the menu item
+     * @return iterator to the line, or lines.end() if there is none
+     */
+    std::vector<Line>::iterator findLine(const std::string &menuItemName);
+
+    /**
+     * @brief Marks the cart as changed and restarts the flush timer.
+     */
+    void changed();
+
+    /**
+     * @brief Writes the changes to the database. Must be called inside a transaction, such as a write of WriteQueue.
+     *
+     * Updates orderNumber and the orderDetailID of new lines as rows are inserted, so the caller must restore them if the
+     * transaction is rolled back.
+     */
+    void write();
+
+    /**
+     * @brief Gets the current local time, formatted as an order date.
+     *
+     * @return the time, formatted as "yyyy-MM-dd hh:mm:ss"
+     */
+    static std::string currentTime();
+
+    CartState(const CartState &other) = delete;
+    CartState& operator=(const CartState &other) = delete;
+};
+
+#endif /* CartState_hpp */
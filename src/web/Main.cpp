@@ -7,11 +7,17 @@
 #include <Wt/WApplication.h>
 
 #include "Application.hpp"
+#include "DBConfig.hpp"
+#include "DBHelper.hpp"
 
 /**
  * Main method runs the Wt Application.
+ *
+ * The "--db-*" options configure the database (see DBConfig::fromArgs()), the rest of the command line is passed to Wt.
  */
 int main(int argc, char **argv) {
+    DBHelper::configure(DBConfig::fromArgs(argc, argv));
+    
     return Wt::WRun(argc, argv, [](const Wt::WEnvironment &env) {
         return std::make_unique<Application>(env);
     });
@@ -6,11 +6,11 @@
 #include "MenuPage.hpp"
 
 MenuPage::MenuPage() {
-    std::vector<MenuItem> menuItems = DBHelper::getInstance().selectWhere(MenuItem());
+    // The menu is shared by all sessions, so showing it does not read the database.
+    std::shared_ptr<const MenuSnapshot> menu = MenuCache::getInstance().get();
     Wt::WContainerWidget *page = addWidget(std::make_unique<Wt::WContainerWidget>());
     addStyleClass("list");
 
-    std::string sessionID = Wt::WApplication::instance()->sessionId();
     bool isAdmin = ((Application *)Application::instance())->getAuth()->IsLoggedIn();
     std::cout << "Is admin: " << isAdmin << std::endl;
 
@@ -28,55 +28,30 @@ MenuPage::MenuPage() {
 
             MenuItem newItem = MenuItem(name, price, description);
             DBHelper::getInstance().insert(newItem);
+            MenuCache::getInstance().reload();
 
             ((Application *)Application::instance())->handleInternalPath("/menu");
         };
         addWidget->getAddItemPtr()->clicked().connect(addItem);
     }
 
-    for (std::vector<MenuItem>::iterator it = menuItems.begin(); it != menuItems.end(); it++) {
-        std::string name = it->getName();
-        double price = it->getPrice();
-        std::string description = it->getDescription();
+    for (std::vector<MenuItem>::const_iterator it = menu->getItems().begin(); it != menu->getItems().end(); it++) {
+        MenuItem menuItem = *it;
+        std::string name = menuItem.getName();
+        double price = menuItem.getPrice();
+        std::string description = menuItem.getDescription();
 
-        auto orderItem = [this, name, sessionID] {
-            time_t now = time(0);
-            std::tm *ltm = localtime(&now);
-            char time_str[20];
-            std::strftime(time_str, 20, "%Y-%m-%d %H:%M:%S", ltm);
-
-            std::vector<SqlCondition> conditions = {SqlCondition("sessionID", "=", sessionID)};
-            conditions.push_back(SqlCondition("status", "=", "cart"));
-            std::vector<OrderMaster> orderMasters = DBHelper::getInstance().selectWhere(OrderMaster(), conditions);
-            long orderNum = 0;
-            if (orderMasters.size() == 0) {
-                OrderMaster orderMast = OrderMaster(0, "test", time_str, "cart", sessionID);
-                orderNum = DBHelper::getInstance().insert(orderMast);
-            } else {
-                orderNum = orderMasters[0].getOrderNumber();
-            }
-
-            conditions = {SqlCondition("orderNumber", "=", (int)orderNum)};
-            conditions.push_back(SqlCondition("menuItemName", "=", name));
-            std::vector<OrderDetail> orderDetails = DBHelper::getInstance().selectWhere(OrderDetail(), conditions);
-            if (orderDetails.size() == 0) {
-                OrderDetail orderDetail = OrderDetail(0, (int)orderNum, name, 1);
-                DBHelper::getInstance().insert(orderDetail);
-            } else {
-                OrderDetail orderDetail = orderDetails[0];
-                orderDetail.setQuantity(orderDetail.getQuantity() + 1);
-                DBHelper::getInstance().update(orderDetail);
-            }
+        auto orderItem = [name] {
+            // Only the session's cart changes here. It is written to the database behind the click.
+            ((Application *)Application::instance())->getCart()->addItem(name);
         };
 
         auto removeItem = [this, name] {
-            std::vector<SqlCondition> conditions = {SqlCondition("name", "=", name)};
-            std::vector<MenuItem> menuItems = DBHelper::getInstance().selectWhere(MenuItem(), conditions);
-            if (menuItems.size() == 0) {
+            if (MenuCache::getInstance().get()->find(name) == -1) {
                 return;
             } else {
-                MenuItem menuItem = menuItems[0];
-                DBHelper::getInstance().destroy(menuItem);
+                DBHelper::getInstance().destroy(MenuItem(name));
+                MenuCache::getInstance().reload();
 
                 ((Application *)Application::instance())->handleInternalPath("/menu");
             }
@@ -10,16 +10,14 @@
 #include <Wt/WContainerWidget.h>
 #include <Wt/WPushButton.h>
 
-#include <ctime>
 #include <string>
 
 #include "Application.hpp"
 #include "Authenticator.hpp"
 #include "DBHelper.hpp"
+#include "MenuCache.hpp"
 #include "MenuItem.hpp"
 #include "MenuWidgets.hpp"
-#include "OrderDetail.hpp"
-#include "OrderMaster.hpp"
 
 /**
  * @brief Class representing the menu page.
@@ -0,0 +1,79 @@
+//
+//  OrderEventBus.cpp
+//
+
+#include "OrderEventBus.hpp"
+
+#include <vector>
+
+#include <Wt/WApplication.h>
+#include <Wt/WServer.h>
+
+OrderEventBus * OrderEventBus::instance = NULL;
+
+std::once_flag OrderEventBus::instanceFlag;
+
+OrderEventBus::OrderEventBus()
+{
+    nextSubscriptionID = 1;
+}
+
+OrderEventBus & OrderEventBus::getInstance()
+{
+    std::call_once(instanceFlag, [] { instance = new OrderEventBus(); });
+    return *instance;
+}
+
+int OrderEventBus::subscribe(Listener listener)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    int subscriptionID = nextSubscriptionID++;
+    subscriptions[subscriptionID] = { Wt::WApplication::instance()->sessionId(), listener };
+    return subscriptionID;
+}
+
+void OrderEventBus::unsubscribe(int subscriptionID)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    subscriptions.erase(subscriptionID);
+}
+
+void OrderEventBus::publish(const OrderEvent &event)
+{
+    // Posted outside the lock, so that a session that is being delivered an event can still unsubscribe.
+    std::vector<std::pair<int, std::string>> recipients;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::map<int, Subscription>::iterator it = subscriptions.begin(); it != subscriptions.end(); ++it)
+        {
+            recipients.push_back(std::make_pair(it->first, it->second.sessionID));
+        }
+    }
+
+    Wt::WServer *server = Wt::WServer::instance();
+    for (std::vector<std::pair<int, std::string>>::iterator it = recipients.begin(); it != recipients.end(); ++it)
+    {
+        int subscriptionID = it->first;
+        server->post(it->second, [this, subscriptionID, event] { deliver(subscriptionID, event); });
+    }
+}
+
+void OrderEventBus::deliver(int subscriptionID, const OrderEvent &event)
+{
+    // The listener is looked up again, because the page that subscribed may have been destroyed since the event was posted.
+    // Unsubscribing happens in this same session, so it cannot happen while the listener runs.
+    Listener listener;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::map<int, Subscription>::iterator subscription = subscriptions.find(subscriptionID);
+        if (subscription == subscriptions.end())
+        {
+            return;
+        }
+        listener = subscription->second.listener;
+    }
+
+    listener(event);
+    Wt::WApplication::instance()->triggerUpdate();
+}
@@ -0,0 +1,158 @@
+//
+//  OrderEventBus.hpp
+//
+
+#ifndef OrderEventBus_hpp
+#define OrderEventBus_hpp
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "OrderMaster.hpp"
+
+/**
+ * @brief A change to the list of open orders.
+ */
+struct OrderEvent
+{
+    /**
+     * @brief What happened to the order.
+     */
+    enum Type
+    {
+        /** The order was checked out and is now open. */
+        Ordered,
+
+        /** The order was completed and is no longer open. */
+        Completed
+    };
+
+    /** What happened to the order. */
+    Type type;
+
+    /** The order, as it is after the change. */
+    OrderMaster order;
+};
+
+/**
+ * @brief Process-wide bus that tells every session showing the open orders when an order is checked out or completed.
+ *
+ * A session subscribes with a listener, which is called in that session through Wt::WServer::post(), so it can update its widgets
+ * directly. The session is pushed the changes afterwards, so it must have called Wt::WApplication::enableUpdates().
+ *
+ * Thread-safe.
+ */
+class OrderEventBus
+{
+public:
+    /**
+     * @brief Called in the subscribed session for each event.
+     */
+    typedef std::function<void(const OrderEvent &)> Listener;
+
+    /**
+     * @brief Gets the singleton instance of this class.
+     *
+     * @return singleton instance of OrderEventBus
+     */
+    static OrderEventBus & getInstance();
+
+    /**
+     * @brief Subscribes the current session to the events published from now on.
+     *
+     * Must be called from within a session.
+     *
+     * @param listener called in the current session for each event
+     * @return the subscription ID, to be passed to unsubscribe()
+     */
+    int subscribe(Listener listener);
+
+    /**
+     * @brief Stops calling the listener of a subscription, including for events that were published but not delivered yet.
+     *
+     * Must be called from within the session that subscribed, before anything the listener uses is destroyed.
+     *
+     * @param subscriptionID the ID returned by subscribe()
+     */
+    void unsubscribe(int subscriptionID);
+
+    /**
+     * @brief Sends an event to every subscribed session, including the current one. Returns without waiting for them.
+     *
+     * Should be called after the change has been committed to the database.
+     *
+     * @param event the event
+     */
+    void publish(const OrderEvent &event);
+
+private:
+    /**
+     * @brief A subscribed session and its listener.
+     */
+    struct Subscription
+    {
+        /** The Wt session ID of the subscribed session. */
+        std::string sessionID;
+
+        /** Called in the session for each event. */
+        Listener listener;
+    };
+
+    /**
+     * @brief Singleton instance of OrderEventBus.
+     */
+    static OrderEventBus *instance;
+
+    /**
+     * @brief Ensures the singleton instance is only created once.
+     */
+    static std::once_flag instanceFlag;
+
+    /**
+     * @brief Held while subscriptions is used.
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief The subscriptions, by ID.
+     */
+    std::map<int, Subscription> subscriptions;
+
+    /**
+     * @brief The ID of the next subscription.
+     */
+    int nextSubscriptionID;
+
+    /**
+     * @brief Constructor.
+     */
+    OrderEventBus();
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Not implemented to prevent copying of singleton instance.
+     */
+    OrderEventBus(const OrderEventBus &other);
+
+    /**
+     * @brief Assignment operator overload.
+     *
+     * Not implemented to prevent assignment of singleton instance.
+     */
+    OrderEventBus& operator=(const OrderEventBus &other);
+
+    /**
+     * @brief Calls the listener of a subscription, if it is still subscribed, then pushes the changes to the browser.
+     *
+     * Runs in the subscribed session.
+     *
+     * @param subscriptionID the subscription ID
+     * @param event the event
+     */
+    void deliver(int subscriptionID, const OrderEvent &event);
+};
+
+#endif /* OrderEventBus_hpp */
@@ -6,43 +6,146 @@
 
 #include "OrderListPage.hpp"
 
+const int OrderListPage::PAGE_SIZE = 20;
+
 OrderListPage::OrderListPage()
 {
     addStyleClass("list");
     
-    Wt::WContainerWidget *listContainer = addNew<WContainerWidget>();
+    listContainer = addNew<WContainerWidget>();
+    emptyItem = NULL;
     
-    // The orders not marked as complete.
-    std::vector<OrderMaster> orders = DBHelper::getInstance().selectWhere(OrderMaster(), { SqlCondition("status", "=", "ordered") }, "OrderDate");
+    // Orders checked out or completed by any session from now on are pushed to this page.
+    // Subscribing before reading the orders means none can be missed in between. Events for orders that were read anyway are ignored.
+    Wt::WApplication::instance()->enableUpdates(true);
+    subscriptionID = OrderEventBus::getInstance().subscribe([this](const OrderEvent &event) { onOrderEvent(event); });
     
-    if (orders.empty())
-    {
-        listContainer->addNew<Wt::WTemplate>(tr("order-list-empty"));
-    }
+    // Only the first page of the orders not marked as complete is read, and the rest are counted.
+    lastOrderNumber = 0;
+    allOrdersLoaded = false;
     
-    // Iterates the orders and adds them to list.
-    for (std::vector<OrderMaster>::iterator it = orders.begin(); it != orders.end(); ++it)
+    loadMoreBtn = addNew<Wt::WPushButton>("Load More Orders");
+    loadMoreBtn->clicked().connect([this] { loadMoreOrders(); });
+    
+    loadMoreOrders();
+    if (!allOrdersLoaded)
     {
-        listContainer->addWidget(createListItemWidget(listContainer, *it));
+        countOpenOrders();
     }
 }
 
 OrderListPage::~OrderListPage()
 {
-    
+    OrderEventBus::getInstance().unsubscribe(subscriptionID);
+    Wt::WApplication::instance()->enableUpdates(false);
 }
 
-void OrderListPage::onCompleteOrderBtnClicked(Wt::WTemplate *listItem, Wt::WContainerWidget *listContainer, OrderMaster order)
+void OrderListPage::onCompleteOrderBtnClicked(Wt::WTemplate *listItem, OrderMaster order)
 {
     listItem->addStyleClass("list-item-removed");
     // Doesn't work. Using CSS transitions and javascript instead.
     //itemTemplate->animateHide(Wt::WAnimation(Wt::AnimationEffect::SlideInFromLeft | Wt::AnimationEffect::Fade, Wt::TimingFunction::Ease, 500));
     order.setStatus("complete");
-    DBHelper::getInstance().update(order);
+    WriteQueue::getInstance().update(order).get();
+    
+    // The list item is removed by onOrderEvent(), the same as on every other page showing this order.
+    OrderEventBus::getInstance().publish({ OrderEvent::Completed, order });
+}
+
+void OrderListPage::loadMoreOrders()
+{
+    // Each page starts after the last order of the previous one, so reading it costs the same however many orders there are.
+    SqlPage page(PAGE_SIZE);
+    if (lastOrderNumber != 0)
+    {
+        page.after("orderDate", lastOrderDate).after("orderNumber", lastOrderNumber);
+    }
+    std::vector<OrderMaster> orders = DBHelper::getInstance()
+        .selectWhere(OrderMaster(), { SqlCondition("status", "=", "ordered") }, "orderDate, orderNumber", { }, page);
+    
+    // Iterates the orders and adds them to list.
+    for (std::vector<OrderMaster>::iterator it = orders.begin(); it != orders.end(); ++it)
+    {
+        if (!listItems.count(it->getOrderNumber()))
+        {
+            listItems[it->getOrderNumber()] = listContainer->addWidget(createListItemWidget(*it));
+        }
+        lastOrderDate = it->getOrderDate();
+        lastOrderNumber = it->getOrderNumber();
+    }
+    
+    // A page that is not full is the last one.
+    if (orders.size() < PAGE_SIZE)
+    {
+        allOrdersLoaded = true;
+        loadMoreBtn->hide();
+        countOpenOrders();
+    }
+}
+
+void OrderListPage::onOrderEvent(const OrderEvent &event)
+{
+    OrderMaster order = event.order;
+    int orderNumber = order.getOrderNumber();
+    
+    // Items hidden by an earlier event have finished their animation by now, so they are removed for good.
+    for (std::vector<Wt::WTemplate *>::iterator it = hiddenItems.begin(); it != hiddenItems.end(); ++it)
+    {
+        listContainer->removeWidget(*it);
+    }
+    hiddenItems.clear();
+    
+    if (event.type == OrderEvent::Ordered)
+    {
+        if (listItems.count(orderNumber))
+        {
+            return;
+        }
+        // Orders are listed by date, so a new order goes at the end. Until the end has been loaded, it is left to a later page.
+        if (allOrdersLoaded)
+        {
+            listItems[orderNumber] = listContainer->addWidget(createListItemWidget(order));
+        }
+    }
+    else if (event.type == OrderEvent::Completed)
+    {
+        std::map<int, Wt::WTemplate *>::iterator item = listItems.find(orderNumber);
+        if (item != listItems.end())
+        {
+            // Hidden by the same CSS transition as when the complete order button is clicked.
+            item->second->addStyleClass("list-item-removed");
+            hiddenItems.push_back(item->second);
+            listItems.erase(item);
+        }
+        else if (allOrdersLoaded)
+        {
+            return;
+        }
+    }
     
-    if (DBHelper::getInstance().selectWhere(OrderMaster(), { SqlCondition("status", "=", "ordered") }).empty())
+    countOpenOrders();
+}
+
+void OrderListPage::countOpenOrders()
+{
+    // Once every page is loaded, the list holds exactly the open orders, since the events keep it up to date.
+    if (allOrdersLoaded)
+    {
+        openOrderCount = (int)listItems.size();
+    }
+    else
+    {
+        openOrderCount = (int)DBHelper::getInstance().count(OrderMaster(), { SqlCondition("status", "=", "ordered") });
+    }
+    
+    if (openOrderCount == 0 && emptyItem == NULL)
+    {
+        emptyItem = listContainer->addNew<Wt::WTemplate>(tr("order-list-empty"));
+    }
+    else if (openOrderCount != 0 && emptyItem != NULL)
     {
-        listContainer->addNew<Wt::WTemplate>(tr("order-list-empty"));
+        listContainer->removeWidget(emptyItem);
+        emptyItem = NULL;
     }
 }
 
@@ -58,7 +161,7 @@ void OrderListPage::onPanelOrderDetailsCollapsed(Wt::WPanel *panel)
     panel->removeStyleClass("panel-expanded");
 }
 
-std::unique_ptr<Wt::WTemplate> OrderListPage::createListItemWidget(Wt::WContainerWidget *listContainer, OrderMaster order)
+std::unique_ptr<Wt::WTemplate> OrderListPage::createListItemWidget(OrderMaster order)
 {
     std::unique_ptr<Wt::WTemplate> item = std::make_unique<Wt::WTemplate>(tr("order-list-item"));
     
@@ -71,7 +174,11 @@ std::unique_ptr<Wt::WTemplate> OrderListPage::createListItemWidget(Wt::WContaine
         completeBtn->setIcon("resources/images/check_circle.png");
         
         Wt::WTemplate *itemRawPtr = item.get();
-        completeBtn->clicked().connect([itemRawPtr, listContainer, order] { onCompleteOrderBtnClicked(itemRawPtr, listContainer, order); });
+        completeBtn->clicked().connect([itemRawPtr, completeBtn, order] {
+            // Disabled so the order cannot be completed twice while its list item is being hidden.
+            completeBtn->disable();
+            onCompleteOrderBtnClicked(itemRawPtr, order);
+        });
         
         // Not a great solution, but Wt animations are bugged and do not seem to work on any browser.
         doJavaScript(item->jsRef() + ".firstElementChild.addEventListener('transitionend', (e) => {"
@@ -102,7 +209,7 @@ std::unique_ptr<Wt::WTemplate> OrderListPage::createListItemWidget(Wt::WContaine
     // View items panel
     if (isLoggedIn)
     {
-        Wt::WPanel *panelOrderDetails = item->bindWidget("panel-orderdetails", createDetailsPanelWidget(order.getOrderNumber()));
+        item->bindWidget("panel-orderdetails", createDetailsPanelWidget(order.getOrderNumber()));
     }
     else
     {
@@ -123,11 +230,16 @@ std::unique_ptr<Wt::WPanel> OrderListPage::createDetailsPanelWidget(int orderNum
     panel->setAnimation(Wt::WAnimation(Wt::AnimationEffect::SlideInFromTop, Wt::TimingFunction::EaseOut, 100));
     
     Wt::WPanel *panelRawPtr = panel.get();
-    panel->expanded().connect([panelRawPtr] { onPanelOrderDetailsExpanded(panelRawPtr); });
+    panel->expanded().connect([this, panelRawPtr, orderNumber] {
+        // The details are only read the first time the panel is opened, since most panels never are.
+        if (panelRawPtr->centralWidget() == NULL)
+        {
+            panelRawPtr->setCentralWidget(createDetailsTableWidget(orderNumber));
+        }
+        onPanelOrderDetailsExpanded(panelRawPtr);
+    });
     panel->collapsed().connect([panelRawPtr] { onPanelOrderDetailsCollapsed(panelRawPtr); });
     
-    panel->setCentralWidget(createDetailsTableWidget(orderNumber));
-    
     return panel;
 }
 
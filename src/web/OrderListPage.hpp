@@ -5,7 +5,9 @@
 #ifndef OrderListPage_hpp
 #define OrderListPage_hpp
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include <Wt/WContainerWidget.h>
 #include <Wt/WTemplate.h>
@@ -19,8 +21,11 @@
 #include <Wt/WAnimation.h>
 
 #include "DBHelper.hpp"
+#include "OrderEventBus.hpp"
 #include "OrderMaster.hpp"
+#include "SqlPage.hpp"
 #include "vOrderDetail.hpp"
+#include "WriteQueue.hpp"
 #include "Page.hpp"
 #include "Application.hpp"
 
@@ -30,6 +35,9 @@
  * Displays a list of the active orders (not in progress or completed).
  * To customers, the list only shows the order number, name, and date.
  * To admins, the list also shows the order details and a complete button for each order.
+ * Orders are shown PAGE_SIZE at a time, with a button to load the next page.
+ * The list is kept current through OrderEventBus, so orders checked out or completed in other sessions appear and disappear
+ * without reloading the page.
  *
  * @author Julian Koksal
  * @date 2022-11-07
@@ -40,27 +48,26 @@ public:
     /**
      * @brief Constructor.
      *
-     * Creates the page widget and all of its contents.
+     * Creates the page widget and all of its contents, and subscribes to OrderEventBus.
      */
     OrderListPage();
     
     /**
      * @brief Destructor.
      *
-     * Does nothing.
+     * Unsubscribes from OrderEventBus.
      */
     ~OrderListPage();
     
     /**
      * @brief Event handler for when the complete order button is clicked.
      *
-     * Updates the order to complete and hides the list item with an animation.
+     * Updates the order to complete, starts hiding the list item with an animation, and publishes the change to OrderEventBus.
      *
      * @param listItem the list item template widget
-     * @param listContainer the list widget
      * @param order the order that the list item represents
      */
-    static void onCompleteOrderBtnClicked(Wt::WTemplate *listItem, Wt::WContainerWidget *listContainer, OrderMaster order);
+    static void onCompleteOrderBtnClicked(Wt::WTemplate *listItem, OrderMaster order);
     
     /**
      * @brief Event handler for when the order details panel is expanded.
@@ -80,6 +87,87 @@ public:
      */
     static void onPanelOrderDetailsCollapsed(Wt::WPanel *panel);
 private:
+    /**
+     * @brief The number of orders read by each click of the load more button.
+     */
+    static const int PAGE_SIZE;
+    
+
+    /**
+     * @brief The list widget.
+     */
+    Wt::WContainerWidget *listContainer;
+    
+    /**
+     * @brief The list item widget of each order in the list, by order number.
+     */
+    std::map<int, Wt::WTemplate *> listItems;
+    
+    /**
+     * @brief List item widgets of completed orders that are being hidden, to be removed on the next event.
+     */
+    std::vector<Wt::WTemplate *> hiddenItems;
+    
+    /**
+     * @brief The button that loads the next page of orders. Hidden once the last page has been loaded.
+     */
+    Wt::WPushButton *loadMoreBtn;
+    
+    /**
+     * @brief The order date of the last order loaded, where the next page starts.
+     */
+    std::string lastOrderDate;
+    
+    /**
+     * @brief The order number of the last order loaded, or 0 if none have been loaded.
+     */
+    int lastOrderNumber;
+    
+    /**
+     * @brief True once the last page of orders has been loaded.
+     */
+    bool allOrdersLoaded;
+    
+    /**
+     * @brief The number of orders that are not complete, including those not loaded yet. Kept up to date by countOpenOrders().
+     */
+    int openOrderCount;
+    
+    /**
+     * @brief The widget shown when there are no orders, NULL if it is not shown.
+     */
+    Wt::WTemplate *emptyItem;
+    
+    /**
+     * @brief The OrderEventBus subscription of this page.
+     */
+    int subscriptionID;
+    
+    /**
+     * @brief Reads the next page of orders and adds them to the list.
+     *
+     * Hides the load more button if it was the last page.
+     */
+    void loadMoreOrders();
+    
+    /**
+     * @brief Updates openOrderCount, and shows the empty list item if there are no open orders.
+     *
+     * Once every page has been loaded, the orders in the list are counted. Until then, the open orders are counted in the
+     * database, since an event for an order that is not in the list cannot tell whether the count already includes it.
+     */
+    void countOpenOrders();
+    
+    /**
+     * @brief Event handler for when an order is checked out or completed in any session.
+     *
+     * Adds or removes the order's list item and counts the open orders again.
+     * Events for orders that are already in or out of the list are ignored.
+     *
+     * @param event the event
+     */
+    void onOrderEvent(const OrderEvent &event);
+    
     /**
      * @brief Creates and returns the list item widget and its contents.
      *
@@ -87,16 +175,16 @@ private:
      * Shows the order number, name, and date to customers.
      * Also shows the order details and complete button to admins.
      *
-     * @param listContainer the list widget
      * @param order the order that the list item represents
      * @return a unique ptr to the list item widget that was created
      */
-    std::unique_ptr<Wt::WTemplate> createListItemWidget(Wt::WContainerWidget *listContainer, OrderMaster order);
+    std::unique_ptr<Wt::WTemplate> createListItemWidget(OrderMaster order);
     
     /**
      * @brief Creates and returns the order details dropdown panel widget.
      *
      * One of these widgets is put into the list item widget for each order.
+     * The panel starts collapsed and empty. Its details table is created when it is first expanded.
      *
      * @param orderNumber the order number of the order that the list item represents
      * @return a unique ptr to the panel widget that was created
@@ -6,6 +6,8 @@
 
 #include "SalesPage.hpp"
 
+#include <iostream>
+
 const int SalesPage::NUM_DAYS_TO_CHART = 366;
 
 const std::vector<Wt::WColor> SalesPage::COLOUR_PALETTE = {
@@ -23,6 +25,8 @@ const std::vector<Wt::WColor> SalesPage::COLOUR_PALETTE = {
 
 SalesPage::SalesPage()
 {
+    salesRequestID = 0;
+    
     bool isLoggedIn = ((Application *)Application::instance())->getAuth()->IsLoggedIn();
     if (!isLoggedIn)
     {
@@ -37,28 +41,64 @@ SalesPage::SalesPage()
     // Inital selected value
     menuItemsToChart = { "All menu items" };
     
-    // The menu is read from the database only once to prevent errors if the menu is changed by some other session.
-    menu = DBHelper::getInstance().selectWhere(MenuItem(), {}, "name");
+    // A skeleton of the chart is shown until the sales have been read.
+    salesTemplate->bindWidget("chart", createSkeletonWidget("Loading sales..."));
+    salesTemplate->bindWidget("legend", std::make_unique<Wt::WContainerWidget>());
+    salesTemplate->bindWidget("btn-group-rev-qty", std::make_unique<Wt::WContainerWidget>());
+    Wt::WPushButton *btnOpenDialog = salesTemplate->bindWidget("btn-menu-item", createBtnOpenDialogWidget());
+    btnOpenDialog->disable();
+    
+    // Y-axis
+    Wt::WText *yAxisTitle = salesTemplate->bindWidget("y-axis-title", std::make_unique<Wt::WText>("Total Revenue ($)"));
+    yAxisTitle->addStyleClass("y-axis-title");
+    
+    // The sales are shared with other sessions through the sales cache, and only read from the database when they have changed.
+    // Reading them can take a while, so it is done off the session, which is free to render the skeleton in the meantime.
+    std::string firstDayStr = Wt::WDate::currentDate().addDays(NUM_DAYS_TO_CHART * -1).toString("yyyy-MM-dd").toUTF8() + " 00:00:00";
+    salesRequestID = AsyncDB::getInstance().run<std::shared_ptr<const SalesCache::Snapshot>>(
+        [firstDayStr] { return SalesCache::getInstance().get(firstDayStr, NUM_DAYS_TO_CHART); },
+        [this, salesTemplate, yAxisTitle](std::shared_ptr<const SalesCache::Snapshot> &snapshot) {
+            salesRequestID = 0;
+            sales = snapshot;
+            showSales(salesTemplate, yAxisTitle);
+        },
+        [this, salesTemplate](const std::exception &e) {
+            salesRequestID = 0;
+            std::cerr << "Error in SalesPage: could not read the sales. " << e.what() << std::endl;
+            salesTemplate->bindWidget("chart", createSkeletonWidget("The sales could not be loaded."));
+        });
+}
+
+SalesPage::~SalesPage()
+{
+    // The sales may still be being read, and must not be shown on this page once it is gone.
+    if (salesRequestID != 0)
+    {
+        AsyncDB::getInstance().cancel(salesRequestID);
+    }
+}
+
+void SalesPage::showSales(Wt::WTemplate *salesTemplate, Wt::WText *yAxisTitle)
+{
+    // The menu comes from the same snapshot as the sales, so it matches the sales even if the menu is changed by some other session.
+    menu = sales->menu;
     
     // The chart model.
     std::shared_ptr<Wt::WStandardItemModel> model = std::make_shared<Wt::WStandardItemModel>(NUM_DAYS_TO_CHART, 1 + 2 * (menu.size() + 1));
     
-    // Chart and legend.
+    // Chart and legend, replacing the skeleton.
     Wt::Chart::WCartesianChart *chart = salesTemplate->bindWidget("chart", createChartWidget(model));
-    Wt::WContainerWidget *legend = salesTemplate->bindWidget("legend", createLegendWidget());
-    
-    // Y-axis
-    Wt::WText *yAxisTitle = salesTemplate->bindWidget("y-axis-title", std::make_unique<Wt::WText>("Total Revenue ($)"));
-    yAxisTitle->addStyleClass("y-axis-title");
+    salesTemplate->bindWidget("legend", createLegendWidget());
     
     // Rev($)-Qty(#) button group
-    Wt::WContainerWidget *btnGroupRevQty = salesTemplate->bindWidget("btn-group-rev-qty", createBtnGroupRevQty(chart, salesTemplate, yAxisTitle));
+    salesTemplate->bindWidget("btn-group-rev-qty", createBtnGroupRevQty(chart, salesTemplate, yAxisTitle));
     
     // Dialog opened by the "Select menu items..." button.
     Wt::WDialog *dialog = addChild(createDialogWidget(chart, salesTemplate));
     
     // "Select menu items..." button.
-    Wt::WPushButton *btnOpenDialog = salesTemplate->bindWidget("btn-menu-item", createBtnOpenDialogWidget());
+    Wt::WPushButton *btnOpenDialog = salesTemplate->resolve<Wt::WPushButton *>("btn-menu-item");
+    btnOpenDialog->enable();
     btnOpenDialog->clicked().connect([dialog, btnOpenDialog] {
         onBtnOpenDialogClick(dialog, btnOpenDialog);
     });
@@ -67,9 +107,15 @@ SalesPage::SalesPage()
     showSeries(chart, salesTemplate);
 }
 
-SalesPage::~SalesPage()
+std::unique_ptr<Wt::WContainerWidget> SalesPage::createSkeletonWidget(std::string message)
 {
+    // The same size as the chart, so the page does not change its layout when the chart replaces it.
+    std::unique_ptr<Wt::WContainerWidget> skeleton = std::make_unique<Wt::WContainerWidget>();
+    skeleton->addStyleClass("sales-chart-skeleton");
+    skeleton->resize("42em", "30em");
+    skeleton->addNew<Wt::WText>(message);
     
+    return skeleton;
 }
 
 std::unique_ptr<Wt::Chart::WCartesianChart> SalesPage::createChartWidget(std::shared_ptr<Wt::WStandardItemModel> model)
@@ -310,65 +356,28 @@ void SalesPage::onBtnOpenDialogClick(Wt::WDialog *dialog, Wt::WPushButton *btnOp
 
 void SalesPage::updateModel(Wt::WAbstractItemModel *model)
 {
-    // Iterates from yesterday to numDaysToChart days ago.
-    for (int daysAgo = 1; daysAgo <= NUM_DAYS_TO_CHART; daysAgo++)
+    // Number of series of each kind (revenue, quantity). Column 1 is all menu items, followed by one column per menu item.
+    int numSeries = (int)menu.size() + 1;
+    
+    // Iterates from numDaysToChart days ago to yesterday.
+    Wt::WDate firstDay = Wt::WDate::currentDate().addDays(NUM_DAYS_TO_CHART * -1);
+    for (int daySeq = 0; daySeq < NUM_DAYS_TO_CHART; ++daySeq)
     {
-        Wt::WDate day = Wt::WDate::currentDate().addDays(daysAgo * -1);
-        std::string dayStr = day.toString("yyyy-MM-dd").toUTF8() + " 00:00:00";
-        int daySeq = NUM_DAYS_TO_CHART - daysAgo;
-        
-        model->setData(daySeq, 0, day); // Sets the first column (x-axis).
-        
-        std::vector<vOrderSales> sales = DBHelper::getInstance().selectWhere(vOrderSales(), { SqlCondition("salesDate", "=", dayStr), },
-                                                                             "isAllMenuItems DESC, menuItemName");
-        
-        int col = 1;
-        // If sales is empty, set all values for the day to 0.
-        if (sales.empty())
+        model->setData(daySeq, 0, firstDay.addDays(daySeq)); // Sets the first column (x-axis).
+        for (int series = 0; series < numSeries; ++series)
         {
-            for (col = 1; col < menu.size() + 2; ++col)
-            {
-                model->setData(daySeq, col, 0.0);
-                model->setData(daySeq, col + (int)menu.size() + 1, 0);
-            }
-        }
-        for (std::vector<vOrderSales>::iterator it = sales.begin(); it != sales.end(); ++it)
-        {
-            std::string menuItemName = it->getMenuItemName();
-            
-            // If a menu item had 0 sales for the day it will not be in the sales vector.
-            // Set the column for that menu item to 0 and move on to the next column.
-            if (col != 1)
-            {
-                while (menuItemName != menu[col - 2].getName())
-                {
-                    model->setData(daySeq, col, 0.0);
-                    model->setData(daySeq, col + (int)menu.size() + 1, 0);
-                    ++col;
-                }
-            }
-            
-            double totalRevenue = it->getTotalRevenue();
-            int totalQuantity = it->getTotalQuantity();
-            
-            model->setData(daySeq, col, totalRevenue);
-            model->setData(daySeq, col + (int)menu.size() + 1, totalQuantity);
-            
-            double &maxRevenue = maxSeriesRevenue[menuItemName];
-            if (totalRevenue > maxRevenue)
-            {
-                maxRevenue = totalRevenue;
-            }
-            
-            int &maxQuantity = maxSeriesQuantity[menuItemName];
-            if (totalQuantity > maxQuantity)
-            {
-                maxQuantity = totalQuantity;
-            }
-            
-            ++col;
+            model->setData(daySeq, series + 1, sales->revenue[series][daySeq]);
+            model->setData(daySeq, series + 1 + numSeries, sales->quantity[series][daySeq]);
         }
     }
+    
+    maxSeriesRevenue["All menu items"] = sales->maxRevenue[0];
+    maxSeriesQuantity["All menu items"] = sales->maxQuantity[0];
+    for (int i = 0; i < menu.size(); ++i)
+    {
+        maxSeriesRevenue[menu[i].getName()] = sales->maxRevenue[i + 1];
+        maxSeriesQuantity[menu[i].getName()] = sales->maxQuantity[i + 1];
+    }
 }
 
 void SalesPage::showSeries(Wt::Chart::WCartesianChart *chart, Wt::WTemplate *salesTemplate)
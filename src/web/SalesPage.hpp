@@ -27,10 +27,12 @@
 #include <Wt/WCheckBox.h>
 
 #include "Application.hpp"
+#include "AsyncDB.hpp"
 #include "DBHelper.hpp"
 #include "SqlCondition.hpp"
 #include "vOrderSales.hpp"
 #include "MenuItem.hpp"
+#include "SalesCache.hpp"
 #include "Page.hpp"
 
 /**
@@ -39,6 +41,9 @@
  * This page displays a chart showing the total sales from orders over time.
  * The chart can be filtered by menu item to compare the sales of specific items.
  *
+ * The sales are read through AsyncDB, so the page is shown with a skeleton of the chart at once, and the chart replaces it when the
+ * sales arrive.
+ *
  * @author Julian Koksal
  * @date 2022-11-13
  */
@@ -48,14 +53,14 @@ public:
     /**
      * @brief Constructor.
      *
-     * Creates the page widget and adds all the content widgets.
+     * Creates the page widget with a skeleton of the chart, and starts reading the sales.
      */
     SalesPage();
     
     /**
      * @brief Destructor.
      *
-     * Does nothing.
+     * Cancels reading the sales, if they have not arrived yet.
      */
     ~SalesPage();
 private:
@@ -70,7 +75,17 @@ private:
     static const std::vector<Wt::WColor> COLOUR_PALETTE;
     
     /**
-     * @brief The menu as retreived from the database.
+     * @brief The sales being charted, shared with other sessions through the sales cache.
+     */
+    std::shared_ptr<const SalesCache::Snapshot> sales;
+    
+    /**
+     * @brief The AsyncDB request ID of reading the sales, or 0 once they have arrived.
+     */
+    int salesRequestID;
+    
+    /**
+     * @brief The menu as retreived from the database, along with the sales.
      */
     std::vector<MenuItem> menu;
     
@@ -94,6 +109,22 @@ private:
      */
     std::map<std::string, int> maxSeriesQuantity;
     
+    /**
+     * @brief Replaces the skeleton with the chart and the widgets that control it, once the sales have arrived.
+     *
+     * @param salesTemplate the page template widget
+     * @param yAxisTitle the y-axis title text widget
+     */
+    void showSales(Wt::WTemplate *salesTemplate, Wt::WText *yAxisTitle);
+    
+    /**
+     * @brief Creates and returns the widget shown in place of the chart until it can be shown.
+     *
+     * @param message the text shown in the widget
+     * @return a unique ptr to the skeleton widget that was created
+     */
+    std::unique_ptr<Wt::WContainerWidget> createSkeletonWidget(std::string message);
+    
     /**
      * @brief Creates and returns the chart widget.
      *
@@ -178,7 +209,7 @@ private:
     static void onBtnOpenDialogClick(Wt::WDialog *dialog, Wt::WPushButton *btnOpenDialog);
     
     /**
-     * @brief Updates the given model with order sales data from the database.
+     * @brief Updates the given model with the order sales data of the sales cache snapshot.
      *
      * The first column is given the dates data, going from 366 days ago to yesterday.
      * The second column is given the total sales data for all menu items.